@@ -41,6 +41,9 @@ void initialize_windows() {
     clear();
     refresh();
 
+    start_color();
+    init_pair(2, COLOR_BLACK, COLOR_BLUE);
+
     task_window = newwin(15, 40, 0, 0);
     box(task_window, 0, 0);
     mvwprintw(task_window, 0, 2, "Tasks");
@@ -297,9 +300,6 @@ void show_tasks() {
     box(task_window, 0, 0);
     mvwprintw(task_window, 0, 2, "Tasks");
 
-    start_color(); 
-    init_pair(2, COLOR_BLACK, COLOR_BLUE); 
-
     for (int i = 0; i < total_tasks; i++) {
         if (i == current_task_index && !is_subtask_mode) {
             wattron(task_window, COLOR_PAIR(2)); 
@@ -313,7 +313,7 @@ void show_tasks() {
             wattroff(task_window, COLOR_PAIR(2));
         }
     }
-    wrefresh(task_window);
+    wnoutrefresh(task_window);
 }
 
 void show_subtasks() { 
@@ -321,9 +321,6 @@ void show_subtasks() {
     box(subtask_window, 0, 0);
     mvwprintw(subtask_window, 0, 2, "Subtasks");
 
-    start_color(); 
-    init_pair(2, COLOR_BLACK, COLOR_BLUE); 
-
     if (total_tasks == 0) {
         mvwprintw(subtask_window, 1, 2, "No tasks available to display subtasks.");
     } else {
@@ -342,7 +339,7 @@ void show_subtasks() {
         }
     }
 
-    wrefresh(subtask_window);
+    wnoutrefresh(subtask_window);
 }
 
 void show_task_metadata() { // Changed function name
@@ -358,9 +355,6 @@ void show_task_metadata() { // Changed function name
     box(description_window, 0, 0);
     mvwprintw(description_window, 0, 2, "Description");
 
-    start_color(); 
-    init_pair(2, COLOR_BLACK, COLOR_BLUE);
-
     if (total_tasks > 0) {
         Task *current_task = &task_list[current_task_index];
         for (int i = 0; i < current_task->tag_count; i++) {
@@ -376,9 +370,9 @@ void show_task_metadata() { // Changed function name
         mvwprintw(description_window, 1, 2, "%s", current_task->details);
     }
 
-    wrefresh(category_window);
-    wrefresh(deadline_window);
-    wrefresh(description_window);
+    wnoutrefresh(category_window);
+    wnoutrefresh(deadline_window);
+    wnoutrefresh(description_window);
 }
 
 void manage_tags() { 
@@ -452,6 +446,7 @@ void manage_tags() {
         }
 
         show_task_metadata(); 
+        doupdate();
     }
 }
 
@@ -793,6 +788,7 @@ void handle_input() {
         show_tasks();
         show_subtasks();
         show_task_metadata(); // Changed function name
+        doupdate();
     }
 }
 
@@ -0,0 +1,173 @@
+#include "batch.h"
+#include "search.h"
+#include "perf.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Splits "word rest" in place: returns word and points rest past the
+// spaces that follow it.
+static char *next_word(char **rest) {
+    char *word = *rest;
+    while (*word == ' ') word++;
+    char *end = word;
+    while (*end && *end != ' ') end++;
+    if (*end) *end++ = '\0';
+    while (*end == ' ') end++;
+    *rest = end;
+    return word;
+}
+
+// "N rest" with N a task number; returns the 0-based index, -1 if the
+// number is missing.
+static int task_argument(char **rest) {
+    char *word = next_word(rest);
+    char *end;
+    long number = strtol(word, &end, 10);
+    if (end == word || *end) return -1;
+    return (int)number - 1;
+}
+
+static char *trim(char *text) {
+    while (*text == ' ') text++;
+    int length = strlen(text);
+    while (length > 0 && text[length - 1] == ' ') text[--length] = '\0';
+    return text;
+}
+
+static int compare_indexes(const void *a, const void *b) {
+    return *(const int *)a - *(const int *)b;
+}
+
+// "delete N M ..." removes all the tasks in one compaction; the numbers
+// may come in any order and repeat.
+static TaskStatus batch_delete(Task task_list[], int *total_tasks, char *rest) {
+    int indexes[MAX_TASKS];
+    int count = 0;
+    while (*rest) {
+        int index = task_argument(&rest);
+        if (index < 0 || index >= *total_tasks) return TASK_NO_SUCH_TASK;
+        if (count < MAX_TASKS) indexes[count++] = index;
+    }
+    if (count == 0) return TASK_NO_SUCH_TASK;
+
+    qsort(indexes, count, sizeof(int), compare_indexes);
+    int unique = 1;
+    for (int i = 1; i < count; i++) {
+        if (indexes[i] != indexes[unique - 1]) indexes[unique++] = indexes[i];
+    }
+    return task_delete_many(task_list, total_tasks, indexes, unique);
+}
+
+static TaskStatus batch_add(Task task_list[], int *total_tasks, char *rest) {
+    char *fields[5] = { "", "", "", "", "1" };
+    for (int i = 0; i < 5 && rest; i++) {
+        char *bar = strchr(rest, '|');
+        if (bar) *bar = '\0';
+        fields[i] = trim(rest);
+        rest = bar ? bar + 1 : NULL;
+    }
+    char *end;
+    long priority = strtol(fields[4], &end, 10);
+    if (end == fields[4] || *end) priority = 0;
+    return task_add(task_list, total_tasks, fields[0], fields[1], fields[2], fields[3], (int)priority);
+}
+
+void batch_print_row(int index, bool is_completed, const char *name, int priority, const char *deadline) {
+    printf("%d. [%c] %s (p%d, %s)\n", index + 1, is_completed ? 'x' : ' ', name, priority, deadline);
+}
+
+static void print_task(Task task_list[], int index) {
+    Task *task = &task_list[index];
+    batch_print_row(index, task->is_completed, task->name, task->priority, task->deadline);
+}
+
+// Returns 0 for an unknown command.
+static int run_command(char *command, char *rest, Task task_list[], int *total_tasks, const char *filename, TaskStatus *status) {
+    *status = TASK_OK;
+    if (strcmp(command, "add") == 0) {
+        *status = batch_add(task_list, total_tasks, rest);
+    } else if (strcmp(command, "name") == 0) {
+        int index = task_argument(&rest);
+        *status = task_set_name(task_list, *total_tasks, index, rest);
+    } else if (strcmp(command, "describe") == 0) {
+        int index = task_argument(&rest);
+        *status = task_set_description(task_list, *total_tasks, index, rest);
+    } else if (strcmp(command, "deadline") == 0) {
+        int index = task_argument(&rest);
+        *status = task_set_deadline(task_list, *total_tasks, index, rest);
+    } else if (strcmp(command, "categories") == 0) {
+        int index = task_argument(&rest);
+        *status = task_set_categories(task_list, *total_tasks, index, rest);
+    } else if (strcmp(command, "toggle") == 0) {
+        *status = task_toggle(task_list, *total_tasks, task_argument(&rest));
+    } else if (strcmp(command, "delete") == 0) {
+        *status = batch_delete(task_list, total_tasks, rest);
+    } else if (strcmp(command, "priority") == 0) {
+        int index = task_argument(&rest);
+        char *end;
+        long priority = strtol(rest, &end, 10);
+        if (end == rest || *end) priority = 0;
+        *status = task_set_priority(task_list, *total_tasks, index, (int)priority);
+    } else if (strcmp(command, "subtask") == 0) {
+        int index = task_argument(&rest);
+        *status = task_add_subtask(task_list, *total_tasks, index, rest);
+    } else if (strcmp(command, "sort") == 0) {
+        sort_tasks(task_list, *total_tasks);
+    } else if (strcmp(command, "search") == 0) {
+        int count = search_run(task_list, *total_tasks, rest);
+        for (int i = 0; i < count; i++) {
+            print_task(task_list, search_match(i));
+        }
+        printf("%d match(es) for \"%s\"\n", count, rest);
+    } else if (strcmp(command, "list") == 0) {
+        for (int i = 0; i < *total_tasks; i++) {
+            print_task(task_list, i);
+        }
+    } else if (strcmp(command, "save") == 0) {
+        if (*rest) {
+            *status = tasks_save(task_list, *total_tasks, rest);
+        } else {
+            *status = tasks_sync(task_list, total_tasks, filename, NULL);
+        }
+    } else if (strcmp(command, "load") == 0) {
+        *status = tasks_load(task_list, total_tasks, *rest ? rest : filename);
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+int run_batch_command(char *line, Task task_list[], int *total_tasks, const char *filename, TaskStatus *status) {
+    char *rest = line;
+    char *command = next_word(&rest);
+    return run_command(command, rest, task_list, total_tasks, filename, status);
+}
+
+int run_batch(FILE *input, Task task_list[], int *total_tasks, const char *filename) {
+    char line[512];
+    int line_number = 0;
+    int command_count = 0;
+    int error_count = 0;
+    double started = perf_now();
+
+    while (fgets(line, sizeof(line), input)) {
+        line_number++;
+        line[strcspn(line, "\r\n")] = '\0';
+        char *rest = line;
+        char *command = next_word(&rest);
+        if (!*command || *command == '#') continue;
+
+        TaskStatus status;
+        command_count++;
+        if (!run_command(command, rest, task_list, total_tasks, filename, &status)) {
+            fprintf(stderr, "line %d: unknown command \"%s\"\n", line_number, command);
+            error_count++;
+        } else if (status != TASK_OK) {
+            fprintf(stderr, "line %d: %s\n", line_number, task_status_message(status));
+            error_count++;
+        }
+    }
+
+    fprintf(stderr, "%d command(s), %d error(s) in %.3f ms\n", command_count, error_count, perf_now() - started);
+    return error_count;
+}
@@ -0,0 +1,33 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include "task_core.h"
+
+// todo --batch: applies one command per line from input to the task list,
+// with no terminal and no rendering.  Tasks are numbered from 1 as in the
+// task pane.
+//
+//   add NAME | CATEGORIES | DD/MM/YYYY | DESCRIPTION | PRIORITY
+//   name N TEXT          describe N TEXT       deadline N DD/MM/YYYY
+//   categories N A, B    toggle N              delete N [N ...]
+//   priority N P         subtask N NAME        sort
+//   search QUERY         list                  save [FILE]
+//   load [FILE]
+//
+// A plain save merges in what other instances saved since the load (see
+// tasks_sync); save FILE writes the list as it is.
+//
+// Blank lines and lines starting with '#' are skipped.  Errors go to
+// stderr with their line number and do not stop the batch; the return
+// value is the number of them.
+int run_batch(FILE *input, Task task_list[], int *total_tasks, const char *filename);
+
+// A single command line, as run_batch runs it; returns 0 for an unknown
+// command.  Used by the daemon to apply its clients' commands.
+int run_batch_command(char *line, Task task_list[], int *total_tasks, const char *filename, TaskStatus *status);
+
+// How list and search print a task.
+void batch_print_row(int index, bool is_completed, const char *name, int priority, const char *deadline);
+
+#endif
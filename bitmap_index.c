@@ -0,0 +1,160 @@
+#include "bitmap_index.h"
+#include "text_fold.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    char key[30];
+    uint64_t *bits;
+} CategoryBitmap;
+
+static CategoryBitmap *categories = NULL;
+static int category_count = 0;
+static int category_capacity = 0;
+
+static uint64_t *done_bits = NULL;
+static uint64_t *undone_bits = NULL;
+
+static int bit_count = 0;
+static int word_capacity = 0;
+
+static void make_key(const char *name, char *key) {
+    fold_text(name, key, 30);
+}
+
+static uint64_t *grow_bitmap(uint64_t *bits, int old_words, int new_words) {
+    bits = realloc(bits, new_words * sizeof(uint64_t));
+    memset(bits + old_words, 0, (new_words - old_words) * sizeof(uint64_t));
+    return bits;
+}
+
+static void reserve_bits(int count) {
+    int words = (count + 63) / 64;
+    if (words <= word_capacity) return;
+    int new_capacity = word_capacity ? word_capacity : 16;
+    while (new_capacity < words) new_capacity *= 2;
+
+    for (int c = 0; c < category_count; c++) {
+        categories[c].bits = grow_bitmap(categories[c].bits, word_capacity, new_capacity);
+    }
+    done_bits = grow_bitmap(done_bits, word_capacity, new_capacity);
+    undone_bits = grow_bitmap(undone_bits, word_capacity, new_capacity);
+    word_capacity = new_capacity;
+}
+
+static CategoryBitmap *find_category(const char *key) {
+    for (int c = 0; c < category_count; c++) {
+        if (strcmp(categories[c].key, key) == 0) return &categories[c];
+    }
+    return NULL;
+}
+
+static CategoryBitmap *intern_category(const char *key) {
+    CategoryBitmap *category = find_category(key);
+    if (category) return category;
+
+    if (category_count == category_capacity) {
+        category_capacity = category_capacity ? category_capacity * 2 : 16;
+        categories = realloc(categories, category_capacity * sizeof(CategoryBitmap));
+    }
+    category = &categories[category_count++];
+    strcpy(category->key, key);
+    category->bits = calloc(word_capacity > 0 ? word_capacity : 1, sizeof(uint64_t));
+    return category;
+}
+
+static void set_bit(uint64_t *bits, int index, bool value) {
+    uint64_t mask = (uint64_t)1 << (index % 64);
+    if (value) bits[index / 64] |= mask;
+    else bits[index / 64] &= ~mask;
+}
+
+static void fill_task(Task *task, int index) {
+    char key[30];
+    for (int c = 0; c < category_count; c++) {
+        set_bit(categories[c].bits, index, false);
+    }
+    for (int i = 0; i < task->category_count; i++) {
+        make_key(task->categories[i], key);
+        set_bit(intern_category(key)->bits, index, true);
+    }
+    set_bit(done_bits, index, task->is_completed);
+    set_bit(undone_bits, index, !task->is_completed);
+}
+
+// Drops bit index and moves every later bit down by one.
+static void remove_bit(uint64_t *bits, int index, int words) {
+    int word = index / 64;
+    uint64_t low_mask = ((uint64_t)1 << (index % 64)) - 1;
+    uint64_t shifted = (bits[word] >> 1) & ~low_mask;
+    bits[word] = (bits[word] & low_mask) | shifted;
+    for (int w = word; w < words; w++) {
+        if (w > word) bits[w] >>= 1;
+        if (w + 1 < words) bits[w] |= bits[w + 1] << 63;
+    }
+    // The word past the last one never holds bits, so the top bit of the
+    // final word is now clear.
+}
+
+void bitmap_index_build(Task task_list[], int total_tasks) {
+    reserve_bits(total_tasks > 0 ? total_tasks : 1);
+    for (int c = 0; c < category_count; c++) {
+        memset(categories[c].bits, 0, word_capacity * sizeof(uint64_t));
+    }
+    memset(done_bits, 0, word_capacity * sizeof(uint64_t));
+    memset(undone_bits, 0, word_capacity * sizeof(uint64_t));
+    bit_count = total_tasks;
+    for (int i = 0; i < total_tasks; i++) {
+        fill_task(&task_list[i], i);
+    }
+}
+
+void bitmap_index_task_changed(Task task_list[], int index) {
+    reserve_bits(index + 1);
+    if (index >= bit_count) bit_count = index + 1;
+    fill_task(&task_list[index], index);
+}
+
+void bitmap_index_task_removed(int index) {
+    if (index >= bit_count) return;
+    int words = (bit_count + 63) / 64;
+    for (int c = 0; c < category_count; c++) {
+        remove_bit(categories[c].bits, index, words);
+    }
+    remove_bit(done_bits, index, words);
+    remove_bit(undone_bits, index, words);
+    bit_count--;
+}
+
+int bitmap_word_count(void) {
+    return (bit_count + 63) / 64;
+}
+
+const uint64_t *bitmap_category(const char *name) {
+    char key[30];
+    make_key(name, key);
+    CategoryBitmap *category = find_category(key);
+    return category ? category->bits : NULL;
+}
+
+const uint64_t *bitmap_done(void) {
+    return done_bits;
+}
+
+const uint64_t *bitmap_undone(void) {
+    return undone_bits;
+}
+
+int bitmap_popcount(const uint64_t *bits) {
+    int count = 0;
+    int words = bitmap_word_count();
+    for (int w = 0; w < words; w++) {
+        count += __builtin_popcountll(bits[w]);
+    }
+    return count;
+}
+
+int bitmap_category_count(const char *name) {
+    const uint64_t *bits = bitmap_category(name);
+    return bits ? bitmap_popcount(bits) : 0;
+}
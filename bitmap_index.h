@@ -0,0 +1,20 @@
+#ifndef BITMAP_INDEX_H
+#define BITMAP_INDEX_H
+
+#include <stdint.h>
+#include "task_manager.h"
+
+// One bitmap per category (names compared folded, see text_fold.h) plus one each for
+// the done and undone tasks; bit i stands for task i.  Category filters
+// become word-wise AND/OR/NOT over these and counts are popcounts.
+void bitmap_index_build(Task task_list[], int total_tasks);
+void bitmap_index_task_changed(Task task_list[], int index);
+void bitmap_index_task_removed(int index);
+int bitmap_word_count(void);
+const uint64_t *bitmap_category(const char *name);
+const uint64_t *bitmap_done(void);
+const uint64_t *bitmap_undone(void);
+int bitmap_popcount(const uint64_t *bits);
+int bitmap_category_count(const char *name);
+
+#endif
@@ -0,0 +1,204 @@
+#include "deadline_index.h"
+#include "task_columns.h"
+#include "task_view.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+typedef struct {
+    int day;
+    int task;
+} DeadlineEntry;
+
+static DeadlineEntry *entries = NULL;
+static int entry_count = 0;
+static int entry_capacity = 0;
+
+// Day number each task is currently filed under, -1 if none.
+static int *task_day = NULL;
+static int task_count = 0;
+static int task_capacity = 0;
+
+static int *range_tasks = NULL;
+static int range_capacity = 0;
+
+static int view_first_day = 0;
+static int view_last_day = 0;
+static bool view_skips_completed = false;
+// Day the overdue/today/week views were opened on, -1 for fixed ranges.
+static int view_anchor_day = -1;
+
+// Position of the first entry not ordered before (day, task).
+static int lower_bound(int day, int task) {
+    int low = 0, high = entry_count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (entries[mid].day < day || (entries[mid].day == day && entries[mid].task < task)) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+static void insert_entry(int day, int task) {
+    if (entry_count == entry_capacity) {
+        entry_capacity = entry_capacity ? entry_capacity * 2 : 128;
+        entries = realloc(entries, entry_capacity * sizeof(DeadlineEntry));
+    }
+    int pos = lower_bound(day, task);
+    memmove(&entries[pos + 1], &entries[pos], (entry_count - pos) * sizeof(DeadlineEntry));
+    entries[pos].day = day;
+    entries[pos].task = task;
+    entry_count++;
+}
+
+static void remove_entry(int day, int task) {
+    int pos = lower_bound(day, task);
+    if (pos < entry_count && entries[pos].day == day && entries[pos].task == task) {
+        memmove(&entries[pos], &entries[pos + 1], (entry_count - pos - 1) * sizeof(DeadlineEntry));
+        entry_count--;
+    }
+}
+
+static int compare_entries(const void *a, const void *b) {
+    const DeadlineEntry *left = a;
+    const DeadlineEntry *right = b;
+    if (left->day != right->day) return left->day < right->day ? -1 : 1;
+    return left->task - right->task;
+}
+
+static void reserve_tasks(int count) {
+    if (count <= task_capacity) return;
+    task_capacity = task_capacity ? task_capacity : 128;
+    while (task_capacity < count) task_capacity *= 2;
+    task_day = realloc(task_day, task_capacity * sizeof(int));
+}
+
+void deadline_index_build(Task task_list[], int total_tasks) {
+    reserve_tasks(total_tasks);
+    if (total_tasks > entry_capacity) {
+        entry_capacity = total_tasks;
+        entries = realloc(entries, entry_capacity * sizeof(DeadlineEntry));
+    }
+
+    entry_count = 0;
+    for (int i = 0; i < total_tasks; i++) {
+        task_day[i] = date_to_day_number(task_list[i].deadline);
+        if (task_day[i] >= 0) {
+            entries[entry_count].day = task_day[i];
+            entries[entry_count++].task = i;
+        }
+    }
+    task_count = total_tasks;
+    qsort(entries, entry_count, sizeof(DeadlineEntry), compare_entries);
+}
+
+void deadline_index_task_changed(Task task_list[], int index) {
+    int day = date_to_day_number(task_list[index].deadline);
+    if (index >= task_count) {
+        reserve_tasks(index + 1);
+        while (task_count <= index) task_day[task_count++] = -1;
+    }
+    if (task_day[index] == day) return;
+
+    if (task_day[index] >= 0) remove_entry(task_day[index], index);
+    if (day >= 0) insert_entry(day, index);
+    task_day[index] = day;
+}
+
+void deadline_index_task_removed(int index) {
+    if (index >= task_count) return;
+    if (task_day[index] >= 0) remove_entry(task_day[index], index);
+    memmove(&task_day[index], &task_day[index + 1], (task_count - index - 1) * sizeof(int));
+    task_count--;
+
+    // Renumbering keeps the order: entries for later tasks stay behind
+    // entries for earlier ones on the same day.
+    for (int i = 0; i < entry_count; i++) {
+        if (entries[i].task > index) entries[i].task--;
+    }
+}
+
+// Tasks due on days first_day..last_day (inclusive), in deadline order.
+int deadline_index_range(int first_day, int last_day, const int **tasks) {
+    int from = lower_bound(first_day, INT_MIN);
+    int to = lower_bound(last_day + 1, INT_MIN);
+    int count = to - from;
+
+    if (count > range_capacity) {
+        range_capacity = count;
+        range_tasks = realloc(range_tasks, range_capacity * sizeof(int));
+    }
+    for (int i = 0; i < count; i++) {
+        range_tasks[i] = entries[from + i].task;
+    }
+    *tasks = range_tasks;
+    return count;
+}
+
+static void refresh_deadline_view(Task task_list[], int total_tasks) {
+    (void)task_list;
+    // Views relative to today move with the date, e.g. when left open past
+    // midnight.
+    if (view_anchor_day >= 0) {
+        int today = today_day_number();
+        if (today != view_anchor_day) {
+            if (view_first_day > 0) view_first_day += today - view_anchor_day;
+            view_last_day += today - view_anchor_day;
+            view_anchor_day = today;
+        }
+    }
+    const int *tasks;
+    int count = deadline_index_range(view_first_day, view_last_day, &tasks);
+
+    view_reset_rows();
+    for (int i = 0; i < count; i++) {
+        if (tasks[i] >= total_tasks) continue;
+        if (view_skips_completed && task_columns.is_completed[tasks[i]]) continue;
+        view_add_row(tasks[i]);
+    }
+}
+
+static void open_deadline_view(const char *title, int first_day, int last_day, bool skip_completed, int anchor_day) {
+    view_anchor_day = anchor_day;
+    view_first_day = first_day;
+    view_last_day = last_day;
+    view_skips_completed = skip_completed;
+    view_open(title, refresh_deadline_view);
+}
+
+void show_overdue_view(void) {
+    int today = today_day_number();
+    open_deadline_view("Overdue", 0, today - 1, true, today);
+}
+
+void show_due_today_view(void) {
+    int today = today_day_number();
+    open_deadline_view("Due today", today, today, false, today);
+}
+
+void show_due_this_week_view(void) {
+    int today = today_day_number();
+    open_deadline_view("Due in the next 7 days", today, today + 6, false, today);
+}
+
+// range is "DD/MM/YYYY DD/MM/YYYY".  Returns 0 if either date is invalid.
+int show_deadline_range_view(const char *range) {
+    char first[11] = "";
+    char last[11] = "";
+    if (sscanf(range, "%10s %10s", first, last) != 2) return 0;
+
+    int first_day = date_to_day_number(first);
+    int last_day = date_to_day_number(last);
+    if (first_day < 0 || last_day < 0) return 0;
+    if (first_day > last_day) {
+        int temp = first_day;
+        first_day = last_day;
+        last_day = temp;
+    }
+
+    char title[64];
+    snprintf(title, sizeof(title), "Due %s - %s", first, last);
+    open_deadline_view(title, first_day, last_day, false, -1);
+    return 1;
+}
@@ -0,0 +1,19 @@
+#ifndef DEADLINE_INDEX_H
+#define DEADLINE_INDEX_H
+
+#include "task_manager.h"
+
+// Tasks ordered by deadline as (day number, task) pairs in one sorted
+// array, so "what is due between A and B" is two binary searches plus the
+// matches.  Tasks without a valid deadline are not in the index.
+void deadline_index_build(Task task_list[], int total_tasks);
+void deadline_index_task_changed(Task task_list[], int index);
+void deadline_index_task_removed(int index);
+int deadline_index_range(int first_day, int last_day, const int **tasks);
+
+void show_overdue_view(void);
+void show_due_today_view(void);
+void show_due_this_week_view(void);
+int show_deadline_range_view(const char *range);
+
+#endif
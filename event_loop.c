@@ -0,0 +1,143 @@
+#define _POSIX_C_SOURCE 200809L
+#include "event_loop.h"
+#include "perf.h"
+#include <errno.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#define MAX_TIMERS 16
+#define MAX_FDS 16
+
+typedef struct {
+    double due;
+    EventCallback callback;
+    void *context;
+    bool active;
+} Timer;
+
+typedef struct {
+    int fd;
+    short events;
+    EventFdCallback callback;
+    void *context;
+} Watch;
+
+static Timer timers[MAX_TIMERS];
+static Watch watches[MAX_FDS];
+static int watch_count = 0;
+static bool frame_requested = false;
+
+void event_loop_request_frame(void) {
+    frame_requested = true;
+}
+
+// Returns -1 when all slots are taken.
+int event_loop_add_timer(double delay_ms, EventCallback callback, void *context) {
+    for (int i = 0; i < MAX_TIMERS; i++) {
+        if (!timers[i].active) {
+            timers[i].due = perf_now() + delay_ms;
+            timers[i].callback = callback;
+            timers[i].context = context;
+            timers[i].active = true;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void event_loop_cancel_timer(int timer) {
+    if (timer >= 0 && timer < MAX_TIMERS) timers[timer].active = false;
+}
+
+int event_loop_add_fd(int fd, short events, EventFdCallback callback, void *context) {
+    if (watch_count >= MAX_FDS) return -1;
+    watches[watch_count].fd = fd;
+    watches[watch_count].events = events;
+    watches[watch_count].callback = callback;
+    watches[watch_count].context = context;
+    watch_count++;
+    return 0;
+}
+
+static void remove_watch(int fd) {
+    for (int i = 0; i < watch_count; i++) {
+        if (watches[i].fd == fd) {
+            watches[i] = watches[--watch_count];
+            return;
+        }
+    }
+}
+
+static void run_due_timers(void) {
+    double now = perf_now();
+    for (int i = 0; i < MAX_TIMERS; i++) {
+        if (!timers[i].active || timers[i].due > now) continue;
+        timers[i].active = false;
+        timers[i].callback(timers[i].context);
+    }
+}
+
+// Milliseconds until the nearest timer, or -1 to block until input.
+static int poll_timeout(void) {
+    double nearest = -1;
+    for (int i = 0; i < MAX_TIMERS; i++) {
+        if (timers[i].active && (nearest < 0 || timers[i].due < nearest)) nearest = timers[i].due;
+    }
+    if (nearest < 0) return -1;
+    double wait = nearest - perf_now();
+    // Round up so the timer is due when poll() returns.
+    return wait <= 0 ? 0 : (int)wait + 1;
+}
+
+static int read_key(void) {
+    nodelay(stdscr, TRUE);
+    int ch = getch();
+    nodelay(stdscr, FALSE);
+    return ch;
+}
+
+int event_loop_next_key(void) {
+    for (;;) {
+        // curses may already hold input it read ahead, which poll() on the
+        // terminal would not see.
+        int ch = read_key();
+        if (ch != ERR) return ch;
+        if (frame_requested) {
+            frame_requested = false;
+            return EVENT_FRAME;
+        }
+
+        struct pollfd fds[MAX_FDS + 1];
+        fds[0].fd = STDIN_FILENO;
+        fds[0].events = POLLIN;
+        for (int i = 0; i < watch_count; i++) {
+            fds[i + 1].fd = watches[i].fd;
+            fds[i + 1].events = watches[i].events;
+        }
+        int count = watch_count;
+        int ready = poll(fds, count + 1, poll_timeout());
+        if (ready < 0) {
+            // A signal, most likely SIGWINCH; curses turns it into
+            // KEY_RESIZE on the next read.
+            if (errno == EINTR) continue;
+            return ERR;
+        }
+        // The terminal is gone; polling it again would return at once,
+        // forever.
+        if (fds[0].revents & (POLLHUP | POLLERR | POLLNVAL)) return ERR;
+
+        run_due_timers();
+        for (int i = 1; i <= count; i++) {
+            if (!fds[i].revents) continue;
+            for (int w = 0; w < watch_count; w++) {
+                if (watches[w].fd == fds[i].fd) {
+                    watches[w].callback(watches[w].fd, watches[w].context);
+                    break;
+                }
+            }
+            // A descriptor that hung up or failed would wake every poll().
+            if (fds[i].revents & (POLLHUP | POLLERR | POLLNVAL)) remove_watch(fds[i].fd);
+        }
+    }
+}
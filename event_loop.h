@@ -0,0 +1,23 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <ncurses.h>
+
+// Returned by event_loop_next_key() instead of a key when a timer or
+// descriptor handler asked for the screen to be redrawn.
+#define EVENT_FRAME (KEY_MAX + 1)
+
+typedef void (*EventCallback)(void *context);
+typedef void (*EventFdCallback)(int fd, void *context);
+
+// The input loop sleeps in poll() on the terminal, the registered
+// descriptors and the nearest timer, so it takes no CPU while idle and
+// wakes exactly when there is something to do.  Timers fire once.
+// event_loop_next_key returns ERR once the terminal has hung up.
+int event_loop_next_key(void);
+void event_loop_request_frame(void);
+int event_loop_add_timer(double delay_ms, EventCallback callback, void *context);
+void event_loop_cancel_timer(int timer);
+int event_loop_add_fd(int fd, short events, EventFdCallback callback, void *context);
+
+#endif
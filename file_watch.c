@@ -0,0 +1,80 @@
+#define _POSIX_C_SOURCE 200809L
+#include "file_watch.h"
+#include <limits.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+// How long the file must stay quiet before the change is reported.
+#define SETTLE_MS 50
+
+static char directory[PATH_MAX];
+static const char *file_name;
+static EventCallback changed_callback;
+static void *changed_context;
+static int settle_timer = -1;
+
+static void settled(void *context) {
+    (void)context;
+    settle_timer = -1;
+    changed_callback(changed_context);
+}
+
+bool file_watch_read(int fd) {
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool changed = false;
+    ssize_t length;
+    while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+        for (char *cursor = buffer; cursor < buffer + length;) {
+            struct inotify_event *event = (struct inotify_event *)cursor;
+            if (event->len && strcmp(event->name, file_name) == 0) changed = true;
+            cursor += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    return changed;
+}
+
+static void read_events(int fd, void *context) {
+    (void)context;
+    if (!file_watch_read(fd)) return;
+
+    event_loop_cancel_timer(settle_timer);
+    settle_timer = event_loop_add_timer(SETTLE_MS, settled, NULL);
+}
+
+int file_watch_open(const char *path) {
+    const char *slash = strrchr(path, '/');
+    if (slash) {
+        int length = slash - path;
+        if (length == 0) length = 1;
+        if (length >= PATH_MAX) return -1;
+        memcpy(directory, path, length);
+        directory[length] = '\0';
+        file_name = slash + 1;
+    } else {
+        strcpy(directory, ".");
+        file_name = path;
+    }
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) return -1;
+    if (inotify_add_watch(fd, directory, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int file_watch_start(const char *path, EventCallback callback, void *context) {
+    int fd = file_watch_open(path);
+    if (fd < 0) return -1;
+    changed_callback = callback;
+    changed_context = context;
+    if (event_loop_add_fd(fd, POLLIN, read_events, NULL) < 0) {
+        close(fd);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,20 @@
+#ifndef FILE_WATCH_H
+#define FILE_WATCH_H
+
+#include <stdbool.h>
+#include "event_loop.h"
+
+// Calls callback from the event loop after path has been written by
+// anyone, this process included.  The directory is watched rather than
+// the file, so saves that replace the file by renaming over it are seen
+// too; a burst of writes is reported once, when it has been quiet for a
+// moment.  Returns -1 if the watch cannot be set up.
+int file_watch_start(const char *path, EventCallback callback, void *context);
+
+// The same watch for a poll loop of its own: file_watch_open returns the
+// descriptor to poll for input, or -1, and file_watch_read drains it and
+// tells whether path was written.  Settling is left to the caller.
+int file_watch_open(const char *path);
+bool file_watch_read(int fd);
+
+#endif
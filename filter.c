@@ -0,0 +1,279 @@
+#include "filter.h"
+#include "task_columns.h"
+#include "task_view.h"
+#include "text_arena.h"
+#include "text_fold.h"
+#include "bitmap_index.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+enum {
+    OP_PRIORITY,
+    OP_DUE,
+    OP_DONE,
+    OP_UNDONE,
+    OP_CATEGORY,
+    OP_TEXT,
+    OP_NOT,
+    OP_AND,
+    OP_OR
+};
+
+enum { CMP_LT, CMP_LE, CMP_GT, CMP_GE, CMP_EQ, CMP_NE };
+
+static FilterProgram active_program;
+
+static bool compare_values(int left, unsigned char compare, int right) {
+    switch (compare) {
+        case CMP_LT: return left < right;
+        case CMP_LE: return left <= right;
+        case CMP_GT: return left > right;
+        case CMP_GE: return left >= right;
+        case CMP_EQ: return left == right;
+        default: return left != right;
+    }
+}
+
+// Reads "<", "<=", ... at *cursor.  Returns -1 if there is no operator.
+static int parse_compare(const char **cursor) {
+    const char *p = *cursor;
+    int compare = -1;
+    if (p[0] == '<' && p[1] == '=') compare = CMP_LE;
+    else if (p[0] == '>' && p[1] == '=') compare = CMP_GE;
+    else if (p[0] == '!' && p[1] == '=') compare = CMP_NE;
+    else if (p[0] == '<') compare = CMP_LT;
+    else if (p[0] == '>') compare = CMP_GT;
+    else if (p[0] == '=') compare = CMP_EQ;
+    if (compare < 0) return -1;
+    *cursor = p + (compare == CMP_LE || compare == CMP_GE || compare == CMP_NE ? 2 : 1);
+    return compare;
+}
+
+static bool emit(FilterProgram *program, unsigned char opcode, int compare, int string, int value) {
+    if (program->op_count >= FILTER_MAX_OPS) return false;
+    FilterOp *op = &program->ops[program->op_count++];
+    op->opcode = opcode;
+    op->compare = (unsigned char)compare;
+    op->string = (short)string;
+    op->value = value;
+    return true;
+}
+
+static int add_string(FilterProgram *program, const char *text, int length, bool fold) {
+    if (program->string_count >= FILTER_MAX_STRINGS) return -1;
+    if (length > 99) length = 99;
+    char raw[100];
+    memcpy(raw, text, length);
+    raw[length] = '\0';
+    char *copy = program->strings[program->string_count];
+    if (fold) {
+        fold_text(raw, copy, 100);
+    } else {
+        strcpy(copy, raw);
+    }
+    return program->string_count++;
+}
+
+int filter_compile(const char *source, FilterProgram *program, char *error, int error_size) {
+    const char *cursor = source;
+    int term_count = 0;
+
+    program->op_count = 0;
+    program->string_count = 0;
+
+    for (;;) {
+        while (*cursor == ' ') cursor++;
+        if (!*cursor) break;
+
+        const char *term_start = cursor;
+        bool negate = false;
+        if (*cursor == '!') {
+            negate = true;
+            cursor++;
+        }
+
+        bool ok = true;
+        if (*cursor == '"') {
+            const char *text = ++cursor;
+            while (*cursor && *cursor != '"') cursor++;
+            if (*cursor != '"') {
+                snprintf(error, error_size, "Unterminated quote at column %d", (int)(text - source));
+                return 0;
+            }
+            int string = add_string(program, text, cursor - text, true);
+            cursor++;
+            ok = string >= 0 && emit(program, OP_TEXT, 0, string, 0);
+        } else if (strncmp(cursor, "cat:", 4) == 0) {
+            cursor += 4;
+            for (int alternative = 0; ok; alternative++) {
+                const char *name = cursor;
+                while (*cursor && *cursor != ' ' && *cursor != '|') cursor++;
+                int string = add_string(program, name, cursor - name, false);
+                ok = string >= 0 && emit(program, OP_CATEGORY, 0, string, 0);
+                if (ok && alternative > 0) ok = emit(program, OP_OR, 0, 0, 0);
+                if (*cursor != '|') break;
+                cursor++;
+            }
+        } else if (strncmp(cursor, "prio", 4) == 0 && strchr("<>=!", cursor[4])) {
+            cursor += 4;
+            int compare = parse_compare(&cursor);
+            if (compare < 0 || !isdigit((unsigned char)*cursor)) {
+                snprintf(error, error_size, "Expected prio<N, prio<=N, ... at column %d", (int)(term_start - source) + 1);
+                return 0;
+            }
+            int value = 0;
+            while (isdigit((unsigned char)*cursor)) value = value * 10 + (*cursor++ - '0');
+            ok = emit(program, OP_PRIORITY, compare, 0, value);
+        } else if (strncmp(cursor, "due", 3) == 0 && strchr("<>=!", cursor[3])) {
+            cursor += 3;
+            int compare = parse_compare(&cursor);
+            char date[11] = "";
+            if (compare >= 0) {
+                strncpy(date, cursor, 10);
+                date[10] = '\0';
+            }
+            int day = date_to_day_number(date);
+            if (compare < 0 || day < 0) {
+                snprintf(error, error_size, "Expected due<DD/MM/YYYY, ... at column %d", (int)(term_start - source) + 1);
+                return 0;
+            }
+            cursor += 10;
+            ok = emit(program, OP_DUE, compare, 0, day);
+        } else if (strncmp(cursor, "done", 4) == 0 && (cursor[4] == ' ' || cursor[4] == '\0')) {
+            cursor += 4;
+            ok = emit(program, negate ? OP_UNDONE : OP_DONE, 0, 0, 0);
+            negate = false;
+        } else {
+            const char *word = cursor;
+            while (*cursor && *cursor != ' ') cursor++;
+            int string = add_string(program, word, cursor - word, true);
+            ok = string >= 0 && emit(program, OP_TEXT, 0, string, 0);
+        }
+
+        if (ok && negate) ok = emit(program, OP_NOT, 0, 0, 0);
+        if (ok && term_count > 0) ok = emit(program, OP_AND, 0, 0, 0);
+        if (!ok) {
+            snprintf(error, error_size, "Filter too long at column %d", (int)(term_start - source) + 1);
+            return 0;
+        }
+        if (*cursor && *cursor != ' ') {
+            snprintf(error, error_size, "Unexpected '%c' at column %d", *cursor, (int)(cursor - source) + 1);
+            return 0;
+        }
+        term_count++;
+    }
+    return 1;
+}
+
+static uint64_t compare_block(const int *column, int base, int rows, unsigned char compare, int value, bool need_date) {
+    uint64_t mask = 0;
+    for (int r = 0; r < rows; r++) {
+        int cell = column[base + r];
+        if (need_date && cell < 0) continue;
+        if (compare_values(cell, compare, value)) mask |= (uint64_t)1 << r;
+    }
+    return mask;
+}
+
+// Runs the program over 64 tasks at a time: every op produces a 64-bit
+// mask, so category and completion terms are single word loads from the
+// bitmap index and AND/OR/NOT are single bitwise instructions.
+static void evaluate_program(const FilterProgram *program, int total_tasks, uint64_t *result) {
+    const uint64_t *category_bits[FILTER_MAX_STRINGS];
+    for (int i = 0; i < program->op_count; i++) {
+        if (program->ops[i].opcode == OP_CATEGORY) {
+            category_bits[program->ops[i].string] = bitmap_category(program->strings[program->ops[i].string]);
+        }
+    }
+
+    int words = (total_tasks + 63) / 64;
+    for (int w = 0; w < words; w++) {
+        int base = w * 64;
+        int rows = total_tasks - base < 64 ? total_tasks - base : 64;
+        uint64_t valid = rows == 64 ? ~(uint64_t)0 : ((uint64_t)1 << rows) - 1;
+        uint64_t stack[FILTER_MAX_OPS];
+        int top = 0;
+
+        for (int i = 0; i < program->op_count; i++) {
+            const FilterOp *op = &program->ops[i];
+            switch (op->opcode) {
+                case OP_PRIORITY:
+                    stack[top++] = compare_block(task_columns.priority, base, rows, op->compare, op->value, false);
+                    break;
+                case OP_DUE:
+                    stack[top++] = compare_block(task_columns.due_day, base, rows, op->compare, op->value, true);
+                    break;
+                case OP_DONE:
+                    stack[top++] = bitmap_done()[w];
+                    break;
+                case OP_UNDONE:
+                    stack[top++] = bitmap_undone()[w];
+                    break;
+                case OP_CATEGORY: {
+                    const uint64_t *bits = category_bits[op->string];
+                    stack[top++] = bits ? bits[w] : 0;
+                    break;
+                }
+                case OP_TEXT: {
+                    uint64_t mask = 0;
+                    for (int r = 0; r < rows; r++) {
+                        if (task_match_fields(base + r, program->strings[op->string])) mask |= (uint64_t)1 << r;
+                    }
+                    stack[top++] = mask;
+                    break;
+                }
+                case OP_NOT:
+                    stack[top - 1] = ~stack[top - 1] & valid;
+                    break;
+                case OP_AND:
+                    top--;
+                    stack[top - 1] &= stack[top];
+                    break;
+                case OP_OR:
+                    top--;
+                    stack[top - 1] |= stack[top];
+                    break;
+            }
+        }
+        result[w] = top == 0 ? valid : stack[0] & valid;
+    }
+}
+
+static void refresh_filter_view(Task task_list[], int total_tasks) {
+    static uint64_t *result = NULL;
+    static int result_words = 0;
+    int words = (total_tasks + 63) / 64;
+    if (words > result_words) {
+        result = realloc(result, words * sizeof(uint64_t));
+        result_words = words;
+    }
+
+    (void)task_list;
+    evaluate_program(&active_program, total_tasks, result);
+    view_reset_rows();
+    for (int w = 0; w < words; w++) {
+        for (uint64_t bits = result[w]; bits; bits &= bits - 1) {
+            view_add_row(w * 64 + __builtin_ctzll(bits));
+        }
+    }
+}
+
+// Compiles source and shows its matches as the task list view; an empty
+// filter goes back to showing every task.
+int filter_apply(const char *source, char *error, int error_size) {
+    FilterProgram program;
+    if (!filter_compile(source, &program, error, error_size)) return 0;
+
+    if (program.op_count == 0) {
+        view_close();
+        return 1;
+    }
+    active_program = program;
+
+    char title[64];
+    snprintf(title, sizeof(title), "Filter: %s", source);
+    view_open(title, refresh_filter_view);
+    return 1;
+}
@@ -0,0 +1,41 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+#include "task_manager.h"
+
+#define FILTER_MAX_OPS 64
+#define FILTER_MAX_STRINGS 8
+
+// Filter expressions are a space-separated list of terms that must all
+// hold; '!' in front of a term negates it:
+//
+//     cat:Work prio<=3 due<01/03/2025 !done "report"
+//
+//   done              task is completed
+//   cat:NAME          task has category NAME (case-insensitive);
+//                     cat:A|B matches either category
+//   prio OP N         priority compared with N
+//   due OP DD/MM/YYYY deadline compared with the date
+//   "text" or word    text occurs in the task (like search)
+//
+// where OP is one of < <= > >= = !=.  The expression is compiled once into
+// a postfix predicate program and evaluated 64 tasks at a time over
+// task_columns and the bitmap index.
+typedef struct {
+    unsigned char opcode;
+    unsigned char compare;
+    short string;
+    int value;
+} FilterOp;
+
+typedef struct {
+    FilterOp ops[FILTER_MAX_OPS];
+    int op_count;
+    char strings[FILTER_MAX_STRINGS][100];
+    int string_count;
+} FilterProgram;
+
+int filter_compile(const char *source, FilterProgram *program, char *error, int error_size);
+int filter_apply(const char *source, char *error, int error_size);
+
+#endif
@@ -0,0 +1,180 @@
+#define _XOPEN_SOURCE 700
+#include "form.h"
+#include "render.h"
+#include <ncurses.h>
+#include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+
+typedef struct {
+    const char *label;
+    char value[FORM_VALUE_SIZE];
+    int length;
+    int max_length;
+    FormValidate validate;
+} FormField;
+
+static const char *form_title = "";
+static FormSubmit form_submit = NULL;
+static FormField fields[FORM_MAX_FIELDS];
+static int field_count = 0;
+static int current = 0;
+static bool is_active = false;
+static char error[80] = "";
+
+// Bytes of a UTF-8 character still to come after the lead byte typed, and
+// whether they are being dropped because the whole character did not fit.
+static int continuation_left = 0;
+static bool is_dropping = false;
+
+void form_open(const char *title, FormSubmit submit) {
+    form_title = title;
+    form_submit = submit;
+    field_count = 0;
+    current = 0;
+    error[0] = '\0';
+    continuation_left = 0;
+    is_active = true;
+    curs_set(1);
+}
+
+// max_length is the size of the field it ends up in, less the terminator.
+void form_add_field(const char *label, const char *initial, int max_length, FormValidate validate) {
+    if (field_count == FORM_MAX_FIELDS) return;
+    FormField *field = &fields[field_count++];
+    field->label = label;
+    field->max_length = max_length < FORM_VALUE_SIZE - 1 ? max_length : FORM_VALUE_SIZE - 1;
+    field->validate = validate;
+    snprintf(field->value, field->max_length + 1, "%s", initial ? initial : "");
+    field->length = strlen(field->value);
+    // A cut initial value must not end inside a character.
+    int last = field->length;
+    while (last > 0 && ((unsigned char)field->value[last - 1] & 0xC0) == 0x80) last--;
+    if (last > 0 && last - 1 + character_size((unsigned char)field->value[last - 1]) > field->length) {
+        field->length = last - 1;
+        field->value[field->length] = '\0';
+    }
+}
+
+bool form_is_active(void) {
+    return is_active;
+}
+
+static bool check_field(int index) {
+    FormField *field = &fields[index];
+    error[0] = '\0';
+    return !field->validate || field->validate(field->value, error, sizeof(error));
+}
+
+static void close_form(void) {
+    is_active = false;
+    curs_set(0);
+}
+
+static void submit(void) {
+    for (int i = 0; i < field_count; i++) {
+        if (!check_field(i)) {
+            current = i;
+            return;
+        }
+    }
+
+    char values[FORM_MAX_FIELDS][FORM_VALUE_SIZE];
+    for (int i = 0; i < field_count; i++) {
+        memcpy(values[i], fields[i].value, FORM_VALUE_SIZE);
+    }
+    close_form();
+    form_submit(values);
+}
+
+void form_handle_key(int ch) {
+    FormField *field = &fields[current];
+    if (ch == 27) {
+        close_form();
+        mvprintw(status_row, 0, "%s cancelled.", form_title);
+        return;
+    }
+
+    if (ch == '\n' || ch == KEY_ENTER) {
+        if (current == field_count - 1) {
+            submit();
+        } else if (check_field(current)) {
+            current++;
+        }
+    } else if (ch == '\t' || ch == KEY_DOWN) {
+        if (current < field_count - 1) current++;
+        check_field(current);
+    } else if (ch == KEY_BTAB || ch == KEY_UP) {
+        if (current > 0) current--;
+        check_field(current);
+    } else if (ch == KEY_BACKSPACE || ch == 127 || ch == '\b') {
+        // Drop a whole UTF-8 character, not just its last byte.
+        if (field->length > 0) {
+            do {
+                field->length--;
+            } while (field->length > 0 && ((unsigned char)field->value[field->length] & 0xC0) == 0x80);
+        }
+        field->value[field->length] = '\0';
+        check_field(current);
+    } else if (ch == 21) {
+        // Ctrl-U clears the field.
+        field->length = 0;
+        field->value[0] = '\0';
+        check_field(current);
+    } else if (ch >= 0x80 && ch < 0xC0) {
+        // The rest of a character whose lead byte was taken or dropped.
+        if (continuation_left == 0) return;
+        continuation_left--;
+        if (is_dropping || field->length >= field->max_length) return;
+        field->value[field->length++] = (char)ch;
+        field->value[field->length] = '\0';
+        if (continuation_left == 0) check_field(current);
+    } else if (ch >= ' ' && ch < KEY_MIN && ch != 127) {
+        // A character goes in whole or not at all, so the limit never
+        // splits one.
+        int size = character_size((unsigned char)ch);
+        continuation_left = size - 1;
+        is_dropping = field->length + size > field->max_length;
+        if (is_dropping) return;
+        field->value[field->length++] = (char)ch;
+        field->value[field->length] = '\0';
+        if (continuation_left == 0) check_field(current);
+    }
+}
+
+// Two lines from row: the field being edited, then its validation error
+// or a reminder of the keys.  The cursor is left at the end of the value.
+void form_draw(int row) {
+    if (!is_active) return;
+    FormField *field = &fields[current];
+
+    char prompt[100];
+    int prompt_length = snprintf(prompt, sizeof(prompt), "%s [%d/%d] %s: ", form_title, current + 1, field_count, field->label);
+    if (prompt_length >= (int)sizeof(prompt)) prompt_length = sizeof(prompt) - 1;
+
+    // Long values scroll so their end, where typing happens, stays visible;
+    // they scroll by whole characters, measured in columns.
+    int prompt_columns = text_columns(prompt, prompt_length);
+    int room = COLS - prompt_columns - 1;
+    const char *shown = field->value;
+    int shown_columns = text_columns(field->value, field->length);
+    while (room > 0 && shown_columns > room) {
+        int size = character_size((unsigned char)*shown);
+        shown_columns -= text_columns(shown, size);
+        shown += size;
+    }
+
+    move(row, 0);
+    clrtoeol();
+    mvprintw(row, 0, "%s%s", prompt, shown);
+    move(row + 1, 0);
+    clrtoeol();
+    if (error[0]) {
+        attron(A_BOLD);
+        mvprintw(row + 1, 0, "%s", error);
+        attroff(A_BOLD);
+    } else {
+        mvprintw(row + 1, 0, "Enter/Tab next, Shift-Tab back, Ctrl-U clear, Esc cancel");
+    }
+    move(row, prompt_columns + shown_columns);
+}
@@ -0,0 +1,25 @@
+#ifndef FORM_H
+#define FORM_H
+
+#include <stdbool.h>
+
+#define FORM_MAX_FIELDS 8
+#define FORM_VALUE_SIZE 100
+
+// Returns false and fills error when value is not acceptable.
+typedef bool (*FormValidate)(const char *value, char *error, int error_size);
+// Receives every field's value once all of them validate.
+typedef void (*FormSubmit)(char values[][FORM_VALUE_SIZE]);
+
+// An inline form on the status lines, edited one field at a time.  It is
+// fed keys by the input loop like any other command, so the screen keeps
+// redrawing, resizing and running timers while somebody types.  Each edit
+// re-validates the field; Enter on the last field checks them all and
+// hands the values to submit in one go, Escape throws them away.
+void form_open(const char *title, FormSubmit submit);
+void form_add_field(const char *label, const char *initial, int max_length, FormValidate validate);
+bool form_is_active(void);
+void form_handle_key(int ch);
+void form_draw(int row);
+
+#endif
@@ -0,0 +1,80 @@
+#include "fuzzy.h"
+#include <ctype.h>
+#include <stdbool.h>
+
+#define SCORE_MATCH 16
+#define SCORE_GAP_START 3
+#define SCORE_GAP_EXTENSION 1
+#define BONUS_BOUNDARY 8
+#define BONUS_DIGIT_RUN 7
+#define BONUS_CONSECUTIVE 4
+#define FIRST_CHAR_MULTIPLIER 2
+
+enum { CLASS_OTHER, CLASS_LETTER, CLASS_DIGIT };
+
+// Folded text has no upper case left, so there are no camelCase bonuses;
+// UTF-8 lead and continuation bytes count as letters.
+static unsigned char char_class[256];
+static bool tables_ready = false;
+
+static void build_tables(void) {
+    for (int c = 0; c < 256; c++) {
+        if (c >= 0x80 || isalpha(c)) char_class[c] = CLASS_LETTER;
+        else if (isdigit(c)) char_class[c] = CLASS_DIGIT;
+        else char_class[c] = CLASS_OTHER;
+    }
+    tables_ready = true;
+}
+
+static int boundary_bonus(unsigned char previous, unsigned char current) {
+    if (previous == CLASS_OTHER && current != CLASS_OTHER) return BONUS_BOUNDARY;
+    if (previous != CLASS_DIGIT && current == CLASS_DIGIT) return BONUS_DIGIT_RUN;
+    return 0;
+}
+
+int fuzzy_score(const char *text, int length, const char *pattern) {
+    if (!tables_ready) build_tables();
+    const unsigned char *t = (const unsigned char *)text;
+    const unsigned char *p = (const unsigned char *)pattern;
+    if (!p[0]) return 0;
+
+    // Forward pass: find where the first full subsequence match ends.
+    int matched = 0, end = -1;
+    for (int i = 0; i < length; i++) {
+        if (t[i] == p[matched] && !p[++matched]) {
+            end = i;
+            break;
+        }
+    }
+    if (end < 0) return 0;
+
+    // Backward pass: shrink to the shortest window ending there.
+    int start = end;
+    for (int i = end, remaining = matched - 1; i >= 0; i--) {
+        if (t[i] == p[remaining] && --remaining < 0) {
+            start = i;
+            break;
+        }
+    }
+
+    int score = 0, consecutive = 0, index = 0;
+    bool in_gap = false;
+    unsigned char previous = start > 0 ? char_class[t[start - 1]] : CLASS_OTHER;
+    for (int i = start; i <= end; i++) {
+        unsigned char current = char_class[t[i]];
+        if (t[i] == p[index]) {
+            int bonus = boundary_bonus(previous, current);
+            if (consecutive > 0 && bonus < BONUS_CONSECUTIVE) bonus = BONUS_CONSECUTIVE;
+            score += SCORE_MATCH + (index == 0 ? bonus * FIRST_CHAR_MULTIPLIER : bonus);
+            consecutive++;
+            in_gap = false;
+            index++;
+        } else {
+            score -= in_gap ? SCORE_GAP_EXTENSION : SCORE_GAP_START;
+            consecutive = 0;
+            in_gap = true;
+        }
+        previous = current;
+    }
+    return score > 0 ? score : 1;
+}
@@ -0,0 +1,12 @@
+#ifndef FUZZY_H
+#define FUZZY_H
+
+// fzf-style fuzzy matching: pattern must occur in the first length bytes
+// of text as a subsequence.  Both are expected to be folded already (see
+// text_fold.h), which is what makes the match case-insensitive.  Returns 0
+// when it does not occur, otherwise a positive score that rewards matches
+// at word and digit-run starts and in consecutive runs and penalises gaps
+// between matched characters.
+int fuzzy_score(const char *text, int length, const char *pattern);
+
+#endif
@@ -0,0 +1,86 @@
+#include "macro.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int keys[MACRO_MAX_KEYS];
+static int key_count = 0;
+static bool is_recording = false;
+// Whether the last key passed to macro_record fitted in the buffer.
+static bool last_key_kept = false;
+
+// Replay state: the pass being played and the next key in it.
+static int passes = 0;
+static int pass = 0;
+static int position = 0;
+static int *targets = NULL;
+static bool target_sent = false;
+
+void macro_start_recording(void) {
+    key_count = 0;
+    last_key_kept = false;
+    is_recording = true;
+}
+
+// The key that stopped the recording was recorded too, unless the buffer
+// was already full; it is not part of the macro.
+void macro_stop_recording(void) {
+    is_recording = false;
+    if (last_key_kept) key_count--;
+}
+
+bool macro_is_recording(void) {
+    return is_recording;
+}
+
+void macro_record(int ch) {
+    if (!is_recording) return;
+    last_key_kept = key_count < MACRO_MAX_KEYS;
+    if (last_key_kept) keys[key_count++] = ch;
+}
+
+int macro_length(void) {
+    return key_count;
+}
+
+void macro_replay(int times) {
+    free(targets);
+    targets = NULL;
+    passes = key_count > 0 ? times : 0;
+    pass = 0;
+    position = 0;
+}
+
+// One pass per target, each starting with that task selected.  The
+// targets are task indexes as they are now, so a macro that deletes tasks
+// should not be replayed this way.
+void macro_replay_over(const int *new_targets, int target_count) {
+    macro_replay(target_count);
+    if (passes == 0) return;
+    targets = malloc(target_count * sizeof(int));
+    memcpy(targets, new_targets, target_count * sizeof(int));
+    target_sent = false;
+}
+
+bool macro_is_replaying(void) {
+    return pass < passes;
+}
+
+int macro_next_key(void) {
+    if (targets && !target_sent) {
+        target_sent = true;
+        return MACRO_SELECT_TARGET;
+    }
+
+    int ch = keys[position++];
+    if (position == key_count) {
+        position = 0;
+        target_sent = false;
+        pass++;
+    }
+    return ch;
+}
+
+// Task selected by the last MACRO_SELECT_TARGET.
+int macro_target(void) {
+    return targets ? targets[pass] : -1;
+}
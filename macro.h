@@ -0,0 +1,29 @@
+#ifndef MACRO_H
+#define MACRO_H
+
+#include <ncurses.h>
+#include <stdbool.h>
+
+#define MACRO_MAX_KEYS 1024
+
+// Handed out by macro_next_key() before each pass of a replay over
+// targets: the input loop selects macro_target() and carries on with the
+// recorded keys.
+#define MACRO_SELECT_TARGET (KEY_MAX + 2)
+
+// Keystroke macros.  While recording, every key read from the terminal is
+// kept.  A replay feeds the keys back through the input loop, either N
+// times or once per target task; since the loop only draws when no input
+// is waiting, the whole replay ends in a single frame.
+void macro_start_recording(void);
+void macro_stop_recording(void);
+bool macro_is_recording(void);
+void macro_record(int ch);
+int macro_length(void);
+void macro_replay(int times);
+void macro_replay_over(const int *targets, int target_count);
+bool macro_is_replaying(void);
+int macro_next_key(void);
+int macro_target(void);
+
+#endif
@@ -1,13 +1,56 @@
 #include "ui_controll.h"
 #include "task_manager.h"
+#include "batch.h"
+#include "perf.h"
+#include "store_protocol.h"
+#include "store_server.h"
+#include "store_client.h"
+#include <locale.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 
-int main() {
-    Task task_list[100];
+// todo --batch [FILE] runs the commands in FILE (or standard input)
+// against tasks.json without starting curses; see batch.h.  With a daemon
+// running they go to it instead, and nothing is loaded here.
+static int run_batch_mode(Task task_list[], int *total_tasks, const char *path) {
+    FILE *input = stdin;
+    if (path && (input = fopen(path, "r")) == NULL) {
+        perror(path);
+        return 1;
+    }
+
+    int errors;
+    int server = store_connect(STORE_SOCKET);
+    if (server >= 0) {
+        errors = run_remote_batch(input, server);
+        close(server);
+    } else {
+        tasks_load(task_list, total_tasks, "tasks.json");
+        errors = run_batch(input, task_list, total_tasks, "tasks.json");
+    }
+    if (input != stdin) fclose(input);
+    return errors ? 1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+    static Task task_list[MAX_TASKS];
     int total_tasks = 0;
     int selected_task_index = 0;
     int selected_subtask_index = 0;
     bool is_in_subtask_mode = false;
 
+    if (argc >= 2 && strcmp(argv[1], "--batch") == 0) {
+        return run_batch_mode(task_list, &total_tasks, argc >= 3 ? argv[2] : NULL);
+    }
+    // todo --daemon [SOCKET] serves tasks.json to clients; see store_server.h.
+    if (argc >= 2 && strcmp(argv[1], "--daemon") == 0) {
+        return run_store_server(argc >= 3 ? argv[2] : STORE_SOCKET, task_list, &total_tasks, "tasks.json");
+    }
+
+    // UTF-8 names and descriptions are drawn as text only in the user's
+    // locale; the C locale shows their bytes escaped.
+    setlocale(LC_ALL, "");
     initialize_ui();
     draw_ui();
 
@@ -15,8 +58,12 @@ int main() {
 
     handle_user_input(task_list, &total_tasks, &selected_task_index, &selected_subtask_index, &is_in_subtask_mode);
 
-    save_tasks_to_file(task_list, total_tasks, "tasks.json");
+    TaskStatus status = tasks_sync(task_list, &total_tasks, "tasks.json", &selected_task_index);
 
     endwin();
+    if (status != TASK_OK) {
+        fprintf(stderr, "tasks.json was not saved: %s\n", task_status_message(status));
+    }
+    perf_report(stderr);
     return 0;
 }
@@ -0,0 +1,73 @@
+#include "marks.h"
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned char *marked = NULL;
+static int marked_length = 0;
+static int marked_capacity = 0;
+static int mark_count = 0;
+
+static int *collected = NULL;
+static int collected_capacity = 0;
+
+void marks_toggle(int task) {
+    if (task >= marked_length) {
+        if (task >= marked_capacity) {
+            marked_capacity = marked_capacity ? marked_capacity : 128;
+            while (marked_capacity <= task) marked_capacity *= 2;
+            marked = realloc(marked, marked_capacity);
+        }
+        memset(marked + marked_length, 0, task + 1 - marked_length);
+        marked_length = task + 1;
+    }
+    marked[task] = !marked[task];
+    mark_count += marked[task] ? 1 : -1;
+}
+
+bool marks_is_marked(int task) {
+    return task < marked_length && marked[task];
+}
+
+int marks_count(void) {
+    return mark_count;
+}
+
+// The marked tasks in ascending order.
+int marks_collect(const int **tasks) {
+    if (mark_count > collected_capacity) {
+        collected_capacity = mark_count;
+        collected = realloc(collected, collected_capacity * sizeof(int));
+    }
+    int count = 0;
+    for (int i = 0; i < marked_length && count < mark_count; i++) {
+        if (marked[i]) collected[count++] = i;
+    }
+    *tasks = collected;
+    return count;
+}
+
+void marks_clear(void) {
+    marked_length = 0;
+    mark_count = 0;
+}
+
+void marks_task_removed(int index) {
+    if (index >= marked_length) return;
+    if (marked[index]) mark_count--;
+    memmove(&marked[index], &marked[index + 1], marked_length - index - 1);
+    marked_length--;
+}
+
+// Task i now is what task source[i] was, or a new one if source[i] is -1.
+void marks_remap(const int source[], int total_tasks) {
+    unsigned char *remapped = calloc(total_tasks > 0 ? total_tasks : 1, 1);
+    mark_count = 0;
+    for (int i = 0; i < total_tasks; i++) {
+        remapped[i] = source[i] >= 0 && marks_is_marked(source[i]);
+        mark_count += remapped[i];
+    }
+    free(marked);
+    marked = remapped;
+    marked_length = total_tasks;
+    marked_capacity = total_tasks > 0 ? total_tasks : 1;
+}
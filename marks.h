@@ -0,0 +1,18 @@
+#ifndef MARKS_H
+#define MARKS_H
+
+#include <stdbool.h>
+
+// Tasks marked for a bulk operation, one flag per task.  Removing a task
+// renumbers the marks behind it and a merge moves them with their tasks;
+// a sort or reload clears them, since the indexes no longer name the same
+// tasks.
+void marks_toggle(int task);
+bool marks_is_marked(int task);
+int marks_count(void);
+int marks_collect(const int **tasks);
+void marks_clear(void);
+void marks_task_removed(int index);
+void marks_remap(const int source[], int total_tasks);
+
+#endif
@@ -0,0 +1,209 @@
+#include "next_up.h"
+#include "render.h"
+#include "task_ids.h"
+#include <limits.h>
+#include <stdlib.h>
+
+#define NOT_ELIGIBLE INT_MIN
+
+typedef struct {
+    int task_id;
+    int score;
+} NextUpEntry;
+
+// Every undone task in a max-heap on urgency, by task id (see
+// task_ids.h), with the slot each id sits in (-1 if it is not in the
+// heap) so an edit can find it.  Keeping them all means a task that drops
+// out of the top K is replaced by the next one in the heap instead of a
+// rescan, and ids mean a delete leaves the other entries alone.
+static NextUpEntry *heap = NULL;
+static int heap_count = 0;
+static int heap_capacity = 0;
+static int *slot_of = NULL;
+static int slot_length = 0;
+static int slot_capacity = 0;
+static int today = 0;
+static bool is_stale = true;
+
+int urgency_score(const Task *task, int today_day) {
+    if (task->is_completed) return NOT_ELIGIBLE;
+
+    int priority = task->priority < 1 ? 1 : (task->priority > 9 ? 9 : task->priority);
+    int score = (10 - priority) * 100;
+
+    int due = date_to_day_number(task->deadline);
+    if (due >= 0) {
+        int days_left = due - today_day;
+        if (days_left < 0) {
+            score += 900 + (-days_left > 30 ? 30 : -days_left) * 10;
+        } else if (days_left < 30) {
+            score += (30 - days_left) * 30;
+        }
+    }
+
+    if (task->subtask_count > 0) {
+        int undone = 0;
+        for (int i = 0; i < task->subtask_count; i++) {
+            if (!task->subtasks[i].is_completed) undone++;
+        }
+        score += undone * 50 / task->subtask_count;
+    }
+    return score;
+}
+
+static void set_entry(int pos, NextUpEntry entry) {
+    heap[pos] = entry;
+    slot_of[entry.task_id] = pos;
+}
+
+static void swap_entries(int a, int b) {
+    NextUpEntry temp = heap[a];
+    set_entry(a, heap[b]);
+    set_entry(b, temp);
+}
+
+static void sift_up(int pos) {
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (heap[parent].score >= heap[pos].score) break;
+        swap_entries(parent, pos);
+        pos = parent;
+    }
+}
+
+static void sift_down(int pos) {
+    for (;;) {
+        int largest = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        if (left < heap_count && heap[left].score > heap[largest].score) largest = left;
+        if (right < heap_count && heap[right].score > heap[largest].score) largest = right;
+        if (largest == pos) break;
+        swap_entries(pos, largest);
+        pos = largest;
+    }
+}
+
+static void grow_heap(int needed) {
+    if (needed <= heap_capacity) return;
+    heap_capacity = heap_capacity ? heap_capacity : 128;
+    while (heap_capacity < needed) heap_capacity *= 2;
+    heap = realloc(heap, heap_capacity * sizeof(NextUpEntry));
+}
+
+// Makes room for tasks up to length - 1; the new ones start outside the
+// heap.
+static void grow_slots(int length) {
+    if (length > slot_capacity) {
+        slot_capacity = slot_capacity ? slot_capacity : 128;
+        while (slot_capacity < length) slot_capacity *= 2;
+        slot_of = realloc(slot_of, slot_capacity * sizeof(int));
+    }
+    for (int i = slot_length; i < length; i++) {
+        slot_of[i] = -1;
+    }
+    if (length > slot_length) slot_length = length;
+}
+
+static void insert(int task_id, int score) {
+    grow_heap(heap_count + 1);
+    grow_slots(task_id + 1);
+    NextUpEntry entry = { task_id, score };
+    set_entry(heap_count, entry);
+    sift_up(heap_count++);
+}
+
+static void remove_at(int pos) {
+    slot_of[heap[pos].task_id] = -1;
+    heap_count--;
+    if (pos == heap_count) return;
+    set_entry(pos, heap[heap_count]);
+    sift_up(pos);
+    sift_down(pos);
+}
+
+void next_up_build(Task task_list[], int total_tasks) {
+    today = today_day_number();
+    grow_heap(total_tasks);
+    slot_length = 0;
+    if (total_tasks > 0) grow_slots(task_id_at(total_tasks - 1) + 1);
+    heap_count = 0;
+    for (int i = 0; i < total_tasks; i++) {
+        int score = urgency_score(&task_list[i], today);
+        if (score == NOT_ELIGIBLE) continue;
+        NextUpEntry entry = { task_id_at(i), score };
+        set_entry(heap_count++, entry);
+    }
+    for (int pos = heap_count / 2 - 1; pos >= 0; pos--) {
+        sift_down(pos);
+    }
+    is_stale = false;
+}
+
+void next_up_task_changed(Task task_list[], int index) {
+    if (is_stale) return;
+
+    int task_id = task_id_at(index);
+    grow_slots(task_id + 1);
+    int score = urgency_score(&task_list[index], today);
+    int slot = slot_of[task_id];
+    if (slot < 0) {
+        if (score != NOT_ELIGIBLE) insert(task_id, score);
+    } else if (score == NOT_ELIGIBLE) {
+        remove_at(slot);
+    } else {
+        heap[slot].score = score;
+        sift_up(slot);
+        sift_down(slot);
+    }
+}
+
+// Called before task_ids drops the task, so its id still resolves.
+void next_up_task_removed(int index) {
+    if (is_stale) return;
+
+    int task_id = task_id_at(index);
+    if (task_id < slot_length && slot_of[task_id] >= 0) remove_at(slot_of[task_id]);
+}
+
+int next_up_collect(Task task_list[], int total_tasks, int out[], int max_out) {
+    if (is_stale || today != today_day_number()) {
+        next_up_build(task_list, total_tasks);
+    }
+
+    // The top K are within the first K levels of the heap: take them best
+    // first, with the children of each one taken becoming candidates.
+    int candidates[NEXT_UP_SIZE + 1];
+    int candidate_count = 0;
+    int count = 0;
+    if (heap_count > 0) candidates[candidate_count++] = 0;
+    while (count < max_out && count < NEXT_UP_SIZE && candidate_count > 0) {
+        int best = 0;
+        for (int i = 1; i < candidate_count; i++) {
+            if (heap[candidates[i]].score > heap[candidates[best]].score) best = i;
+        }
+        int slot = candidates[best];
+        candidates[best] = candidates[--candidate_count];
+        out[count++] = task_index_of(heap[slot].task_id);
+        for (int child = 2 * slot + 1; child <= 2 * slot + 2 && child < heap_count; child++) {
+            candidates[candidate_count++] = child;
+        }
+    }
+    return count;
+}
+
+// Takes over the subtask pane while the panel is switched on.
+void display_next_up(Task task_list[], int total_tasks) {
+    int next[NEXT_UP_SIZE];
+    int count = next_up_collect(task_list, total_tasks, next, NEXT_UP_SIZE);
+
+    render_begin(PANE_SUBTASKS);
+    render_line(PANE_SUBTASKS, 0, A_BOLD, "Next up:");
+    for (int i = 0; i < count; i++) {
+        Task *task = &task_list[next[i]];
+        render_line(PANE_SUBTASKS, 1 + i, A_NORMAL, "%d. (p%d, %s) %s", next[i] + 1, task->priority, task->deadline, task->name);
+    }
+    if (count == 0) {
+        render_line(PANE_SUBTASKS, 1, A_NORMAL, "Nothing left to do.");
+    }
+}
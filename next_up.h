@@ -0,0 +1,20 @@
+#ifndef NEXT_UP_H
+#define NEXT_UP_H
+
+#include "task_manager.h"
+
+#define NEXT_UP_SIZE 5
+
+// Keeps the undone tasks in a max-heap on urgency, and reads the
+// NEXT_UP_SIZE most urgent off its top.  Building costs O(n), a task edit
+// or delete O(log n), and reading the top K O(K^2).  The heap holds every
+// undone task rather than just K, so that a task leaving the top K never
+// needs a rescan to find the one that takes its place.
+void next_up_build(Task task_list[], int total_tasks);
+void next_up_task_changed(Task task_list[], int index);
+void next_up_task_removed(int index);
+int urgency_score(const Task *task, int today);
+int next_up_collect(Task task_list[], int total_tasks, int out[], int max_out);
+void display_next_up(Task task_list[], int total_tasks);
+
+#endif
@@ -0,0 +1,135 @@
+#define _POSIX_C_SOURCE 199309L
+#include "perf.h"
+#include "scan_kernel.h"
+#include <ncurses.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Rings of the most recent samples; older ones are overwritten.
+#define PERF_SAMPLES 4096
+// Keys read since the last frame; a burst longer than this keeps its oldest
+// keys, which are the ones with the worst latency.
+#define PERF_PENDING_KEYS 256
+
+typedef struct {
+    double values[PERF_SAMPLES];
+    int count;
+    int next;
+} Samples;
+
+static const char *op_names[PERF_OP_COUNT] = { "load", "save", "sort", "search" };
+static double last_op[PERF_OP_COUNT];
+static bool op_seen[PERF_OP_COUNT];
+
+static Samples frame_times;
+static Samples key_latencies;
+static double pending_keys[PERF_PENDING_KEYS];
+static int pending_count = 0;
+static long frame_total = 0;
+static bool overlay_shown = false;
+
+// The overlay's percentiles, worked out at most every OVERLAY_REFRESH_MS so
+// that sorting the rings does not weigh on the frames being measured.
+#define OVERLAY_REFRESH_MS 500
+static double overlay_p50 = 0;
+static double overlay_p99 = 0;
+static double overlay_computed_at = -OVERLAY_REFRESH_MS;
+
+double perf_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1e6;
+}
+
+static void add_sample(Samples *samples, double value) {
+    samples->values[samples->next] = value;
+    samples->next = (samples->next + 1) % PERF_SAMPLES;
+    if (samples->count < PERF_SAMPLES) samples->count++;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double left = *(const double *)a;
+    double right = *(const double *)b;
+    return (left > right) - (left < right);
+}
+
+// Nearest-rank percentile of the samples currently held.
+static double percentile(const Samples *samples, double rank) {
+    if (samples->count == 0) return 0;
+    static double sorted[PERF_SAMPLES];
+    memcpy(sorted, samples->values, samples->count * sizeof(double));
+    qsort(sorted, samples->count, sizeof(double), compare_doubles);
+    int index = (int)(rank * samples->count + 0.999999) - 1;
+    if (index < 0) index = 0;
+    if (index >= samples->count) index = samples->count - 1;
+    return sorted[index];
+}
+
+void perf_record(PerfOp op, double started) {
+    last_op[op] = perf_now() - started;
+    op_seen[op] = true;
+}
+
+void perf_key_read(void) {
+    if (pending_count < PERF_PENDING_KEYS) {
+        pending_keys[pending_count++] = perf_now();
+    }
+}
+
+// Called once the frame is on the terminal: every key read since the
+// previous frame has now been painted.
+void perf_frame_done(double started) {
+    double now = perf_now();
+    add_sample(&frame_times, now - started);
+    for (int i = 0; i < pending_count; i++) {
+        add_sample(&key_latencies, now - pending_keys[i]);
+    }
+    pending_count = 0;
+    frame_total++;
+}
+
+void perf_toggle_overlay(void) {
+    overlay_shown = !overlay_shown;
+    overlay_computed_at = -OVERLAY_REFRESH_MS;
+}
+
+bool perf_overlay_enabled(void) {
+    return overlay_shown;
+}
+
+void perf_draw_overlay(int row) {
+    double last_frame = frame_times.count ? frame_times.values[(frame_times.next + PERF_SAMPLES - 1) % PERF_SAMPLES] : 0;
+    double now = perf_now();
+    if (now - overlay_computed_at >= OVERLAY_REFRESH_MS) {
+        overlay_p50 = percentile(&key_latencies, 0.50);
+        overlay_p99 = percentile(&key_latencies, 0.99);
+        overlay_computed_at = now;
+    }
+    move(row, 0);
+    clrtoeol();
+    attron(A_REVERSE);
+    printw("frame %.2fms  key->paint p50 %.2fms p99 %.2fms ", last_frame, overlay_p50, overlay_p99);
+    for (int op = 0; op < PERF_OP_COUNT; op++) {
+        if (op_seen[op]) printw(" %s %.2fms", op_names[op], last_op[op]);
+    }
+    printw("  scan %s", scan_kernel_name());
+    attroff(A_REVERSE);
+}
+
+// Printed after endwin() at every exit of the curses front end.
+void perf_report(FILE *out) {
+    fprintf(out, "frames: %ld\n", frame_total);
+    fprintf(out, "frame time:   p50 %.3f ms  p99 %.3f ms  (last %d frames)\n",
+            percentile(&frame_times, 0.50), percentile(&frame_times, 0.99), frame_times.count);
+    fprintf(out, "key to paint: p50 %.3f ms  p99 %.3f ms  (last %d keys)\n",
+            percentile(&key_latencies, 0.50), percentile(&key_latencies, 0.99), key_latencies.count);
+    for (int op = 0; op < PERF_OP_COUNT; op++) {
+        if (op_seen[op]) {
+            fprintf(out, "last %-6s  %.3f ms\n", op_names[op], last_op[op]);
+        } else {
+            fprintf(out, "last %-6s  -\n", op_names[op]);
+        }
+    }
+    fprintf(out, "scan kernel:  %s\n", scan_kernel_name());
+}
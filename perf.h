@@ -0,0 +1,27 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+typedef enum {
+    PERF_LOAD,
+    PERF_SAVE,
+    PERF_SORT,
+    PERF_SEARCH,
+    PERF_OP_COUNT
+} PerfOp;
+
+// Timings on the monotonic clock, in milliseconds.  Recording a sample is a
+// clock read and a store; percentiles are only worked out when the overlay
+// or the exit report asks for them.
+double perf_now(void);
+void perf_record(PerfOp op, double started);
+void perf_key_read(void);
+void perf_frame_done(double started);
+void perf_toggle_overlay(void);
+bool perf_overlay_enabled(void);
+void perf_draw_overlay(int row);
+void perf_report(FILE *out);
+
+#endif
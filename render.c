@@ -0,0 +1,257 @@
+#define _XOPEN_SOURCE 700
+#include "render.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+// Line buffers hold UTF-8, so a line of width columns can take up to
+// this many bytes per column.
+#define BYTES_PER_COLUMN 4
+
+typedef struct {
+    WINDOW *window;
+    const char *title;
+    int top;
+    int left;
+    int height;
+    int width;
+    char *next;
+    char *shown;
+    int *next_attributes;
+    int *shown_attributes;
+    bool force;
+} Pane;
+
+static Pane panes[PANE_COUNT];
+
+int status_row = 0;
+
+static int line_size(int width) {
+    return width * BYTES_PER_COLUMN + 1;
+}
+
+// Length of the UTF-8 character a byte starts; stray continuation bytes
+// and invalid leads count as one.
+int character_size(unsigned char lead) {
+    if (lead >= 0xF0 && lead < 0xF8) return 4;
+    if (lead >= 0xE0) return lead < 0xF0 ? 3 : 1;
+    if (lead >= 0xC0) return 2;
+    return 1;
+}
+
+// How many bytes of text, in whole characters, fit in max_columns
+// terminal columns; wide characters count two, combining marks none.
+// The columns they take go to *columns if it is not NULL.
+int text_fit(const char *text, int length, int max_columns, int *columns) {
+    int used = 0;
+    int fitted = 0;
+    mbstate_t state;
+    memset(&state, 0, sizeof(state));
+    while (fitted < length) {
+        wchar_t wide;
+        size_t size = mbrtowc(&wide, text + fitted, length - fitted, &state);
+        int width = 1;
+        if (size == (size_t)-1 || size == (size_t)-2 || size == 0) {
+            // Not decodable in this locale: one column per character.
+            size = character_size((unsigned char)text[fitted]);
+            if ((int)size > length - fitted) size = length - fitted;
+            memset(&state, 0, sizeof(state));
+        } else {
+            width = wcwidth(wide);
+            if (width < 0) width = 1;
+        }
+        if (used + width > max_columns) break;
+        used += width;
+        fitted += size;
+    }
+    if (columns) *columns = used;
+    return fitted;
+}
+
+int text_columns(const char *text, int length) {
+    int columns;
+    text_fit(text, length, length, &columns);
+    return columns;
+}
+
+// Each pane owns a boxed window; content goes in the interior, one cell
+// inside the border.  The window and line buffers are only rebuilt when
+// the pane's geometry actually changes.
+static void place_pane(Pane *pane, int top, int left, int height, int width) {
+    if (height < 1) height = 1;
+    if (width < 1) width = 1;
+    if (pane->window && pane->top == top && pane->left == left && pane->height == height && pane->width == width) {
+        return;
+    }
+
+    if (pane->window) delwin(pane->window);
+    free(pane->next);
+    free(pane->shown);
+    free(pane->next_attributes);
+    free(pane->shown_attributes);
+
+    pane->window = newwin(height + 2, width + 2, top - 1, left - 1);
+    pane->top = top;
+    pane->left = left;
+    pane->height = height;
+    pane->width = width;
+    pane->next = calloc(height, line_size(width));
+    pane->shown = calloc(height, line_size(width));
+    pane->next_attributes = calloc(height, sizeof(int));
+    pane->shown_attributes = calloc(height, sizeof(int));
+    pane->force = true;
+}
+
+void render_init(void) {
+    panes[PANE_TASKS].title = "Tasks";
+    panes[PANE_SUBTASKS].title = "Subtasks";
+    panes[PANE_CATEGORIES].title = "Categories";
+    panes[PANE_DEADLINE].title = "Deadline";
+    panes[PANE_DESCRIPTION].title = "Description";
+}
+
+// Splits the terminal into the two list panes on top, categories and
+// deadline below them, and the description across the bottom, with
+// STATUS_LINES rows under the panes for messages and prompts.  The lists
+// get whatever height is left over, so a bigger terminal shows more rows.
+// Up to help_lines rows go to key help when the panes can spare them; the
+// return value is how many did.
+int render_layout(int help_lines) {
+    int available = LINES - STATUS_LINES;
+    int spare = available - MIN_PANE_LINES;
+    if (spare < 0) spare = 0;
+    if (help_lines > spare) help_lines = spare;
+
+    int pane_lines = available - help_lines;
+    int lower = pane_lines >= 19 ? 5 : 3;
+    int upper = pane_lines - 2 * lower;
+    if (upper < 3) upper = 3;
+    int left_width = COLS / 2;
+    int right_width = COLS - left_width;
+
+    place_pane(&panes[PANE_TASKS], 1, 1, upper - 2, left_width - 2);
+    place_pane(&panes[PANE_SUBTASKS], 1, left_width + 1, upper - 2, right_width - 2);
+    place_pane(&panes[PANE_CATEGORIES], upper + 1, 1, lower - 2, left_width - 2);
+    place_pane(&panes[PANE_DEADLINE], upper + 1, left_width + 1, lower - 2, right_width - 2);
+    place_pane(&panes[PANE_DESCRIPTION], upper + lower + 1, 1, lower - 2, COLS - 2);
+
+    status_row = upper + 2 * lower + help_lines;
+    return help_lines;
+}
+
+static char *line_at(Pane *pane, char *lines, int row) {
+    return lines + row * line_size(pane->width);
+}
+
+void render_begin(PaneId id) {
+    Pane *pane = &panes[id];
+    memset(pane->next, 0, pane->height * line_size(pane->width));
+    memset(pane->next_attributes, 0, pane->height * sizeof(int));
+}
+
+// Rows outside the pane are dropped rather than spilling into the
+// neighbouring panes, and lines are cut to the pane's width in columns.
+void render_line(PaneId id, int row, int attributes, const char *format, ...) {
+    Pane *pane = &panes[id];
+    if (row < 0 || row >= pane->height) return;
+
+    char *line = line_at(pane, pane->next, row);
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(line, line_size(pane->width), format, args);
+    va_end(args);
+    if (length >= line_size(pane->width)) length = line_size(pane->width) - 1;
+    if (length < 0) length = 0;
+    line[text_fit(line, length, pane->width, NULL)] = '\0';
+    pane->next_attributes[row] = attributes;
+}
+
+// Preformatted text, for callers that cache their lines.
+void render_text(PaneId id, int row, int attributes, const char *text, int length) {
+    Pane *pane = &panes[id];
+    if (row < 0 || row >= pane->height) return;
+    length = text_fit(text, length, pane->width, NULL);
+
+    char *line = line_at(pane, pane->next, row);
+    memcpy(line, text, length);
+    line[length] = '\0';
+    pane->next_attributes[row] = attributes;
+}
+
+int render_pane_height(PaneId id) {
+    return panes[id].height;
+}
+
+int render_pane_width(PaneId id) {
+    return panes[id].width;
+}
+
+// Changed panes are staged with wnoutrefresh and the whole frame goes out
+// in a single doupdate.  stdscr (key help, messages, prompts) is staged
+// first so the panes always end up on top of it.
+void render_flush(void) {
+    wnoutrefresh(stdscr);
+    for (int id = 0; id < PANE_COUNT; id++) {
+        Pane *pane = &panes[id];
+        bool changed = false;
+        // newwin() fails when the terminal is too small to hold the pane.
+        if (!pane->window) continue;
+        if (pane->force) {
+            werase(pane->window);
+            box(pane->window, 0, 0);
+            mvwprintw(pane->window, 0, 2, "%s", pane->title);
+            // Whatever was staged from stdscr may cover the pane.
+            touchwin(pane->window);
+            changed = true;
+        }
+        for (int row = 0; row < pane->height; row++) {
+            char *next = line_at(pane, pane->next, row);
+            char *shown = line_at(pane, pane->shown, row);
+            if (!pane->force && pane->next_attributes[row] == pane->shown_attributes[row] && strcmp(next, shown) == 0) {
+                continue;
+            }
+
+            int length = strlen(next);
+            int columns = text_columns(next, length);
+            wattron(pane->window, pane->next_attributes[row]);
+            mvwaddnstr(pane->window, row + 1, 1, next, length);
+            wattroff(pane->window, pane->next_attributes[row]);
+            if (columns < pane->width) {
+                mvwhline(pane->window, row + 1, 1 + columns, ' ', pane->width - columns);
+            }
+
+            strcpy(shown, next);
+            pane->shown_attributes[row] = pane->next_attributes[row];
+            changed = true;
+        }
+        if (changed) {
+            wnoutrefresh(pane->window);
+        }
+        pane->force = false;
+    }
+    // Staging stdscr again moves nothing but the cursor, back to wherever
+    // a form being typed into left it.
+    wnoutrefresh(stdscr);
+    doupdate();
+}
+
+// Something else drew over the panes (a clear() of stdscr), so the next
+// flush redraws every pane, border included.
+void render_invalidate(void) {
+    for (int id = 0; id < PANE_COUNT; id++) {
+        panes[id].force = true;
+    }
+}
+
+// Scrolls just far enough to keep selected_row on screen.
+void viewport_follow(Viewport *viewport, int selected_row, int row_count, int height) {
+    if (height <= 0) return;
+    if (selected_row >= 0 && selected_row < viewport->offset) viewport->offset = selected_row;
+    if (selected_row >= viewport->offset + height) viewport->offset = selected_row - height + 1;
+
+    int last_offset = row_count > height ? row_count - height : 0;
+    if (viewport->offset > last_offset) viewport->offset = last_offset;
+    if (viewport->offset < 0) viewport->offset = 0;
+}
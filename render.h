@@ -0,0 +1,52 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <ncurses.h>
+
+typedef enum {
+    PANE_TASKS,
+    PANE_SUBTASKS,
+    PANE_CATEGORIES,
+    PANE_DEADLINE,
+    PANE_DESCRIPTION,
+    PANE_COUNT
+} PaneId;
+
+// Scroll state of a list drawn into a pane: only rows offset ..
+// offset + height - 1 are formatted and drawn, whatever the list length.
+typedef struct {
+    int offset;
+} Viewport;
+
+// Rows kept under the panes for messages and prompts, starting at
+// status_row, and the fewest rows the panes are squeezed into.
+#define STATUS_LINES 4
+#define MIN_PANE_LINES 16
+
+extern int status_row;
+
+// Retained-mode drawing of the panes.  render_layout() sizes one boxed
+// window per pane from LINES and COLS and keeps it until a resize changes
+// that pane's geometry.  The display_* functions
+// describe a pane's content line by line into the next frame;
+// render_flush() compares it with what is on screen, redraws only the lines
+// that differ, and sends the frame to the terminal with one doupdate().
+void render_init(void);
+int render_layout(int help_lines);
+void render_begin(PaneId pane);
+void render_line(PaneId pane, int row, int attributes, const char *format, ...);
+void render_text(PaneId pane, int row, int attributes, const char *text, int length);
+int render_pane_height(PaneId pane);
+int render_pane_width(PaneId pane);
+void render_flush(void);
+void render_invalidate(void);
+void viewport_follow(Viewport *viewport, int selected_row, int row_count, int height);
+
+// UTF-8 text measured in terminal columns, in the user's locale.
+// character_size gives the length of the sequence a lead byte starts;
+// text_fit how many bytes of whole characters fit in max_columns.
+int character_size(unsigned char lead);
+int text_fit(const char *text, int length, int max_columns, int *columns);
+int text_columns(const char *text, int length);
+
+#endif
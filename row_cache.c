@@ -0,0 +1,75 @@
+#include "row_cache.h"
+#include "render.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// One slot of ROW_SIZE bytes per task in a single block, each row cut
+// to width columns.
+#define ROW_SIZE 128
+
+static char *text = NULL;
+static int *lengths = NULL;
+static unsigned char *valid = NULL;
+static int count = 0;
+static int capacity = 0;
+static int width = 0;
+
+static void reserve_rows(int rows, int row_width) {
+    if (rows <= capacity && row_width == width) return;
+    int new_capacity = capacity ? capacity : 128;
+    while (new_capacity < rows) new_capacity *= 2;
+    text = realloc(text, (size_t)new_capacity * ROW_SIZE);
+    lengths = realloc(lengths, new_capacity * sizeof(int));
+    valid = realloc(valid, new_capacity);
+    if (row_width != width) {
+        // Every row has to be cut again to the new width.
+        memset(valid, 0, new_capacity);
+        width = row_width;
+    } else {
+        memset(valid + capacity, 0, new_capacity - capacity);
+    }
+    capacity = new_capacity;
+}
+
+static void format_row(Task *task, int index) {
+    char row[ROW_SIZE];
+    int length = snprintf(row, sizeof(row), "%d. [%c] %s", index + 1, task->is_completed ? 'x' : ' ', task->name);
+    if (length >= (int)sizeof(row)) length = sizeof(row) - 1;
+    // Cut to the pane's width in columns, on a character boundary.
+    length = text_fit(row, length, width, NULL);
+    char *slot = text + (size_t)index * ROW_SIZE;
+    memcpy(slot, row, length);
+    slot[length] = '\0';
+    lengths[index] = length;
+    valid[index] = 1;
+}
+
+void row_cache_build(Task task_list[], int total_tasks) {
+    (void)task_list;
+    if (capacity > 0) memset(valid, 0, capacity);
+    count = total_tasks;
+}
+
+void row_cache_task_changed(Task task_list[], int index) {
+    (void)task_list;
+    if (index < capacity) valid[index] = 0;
+    if (index >= count) count = index + 1;
+}
+
+// Every task after index moves up one place and gets a new number.
+void row_cache_task_removed(int index) {
+    if (index >= count) return;
+    count--;
+    if (index < capacity) {
+        int end = count < capacity ? count : capacity;
+        if (end > index) memset(valid + index, 0, end - index);
+    }
+}
+
+const char *row_cache_task_row(Task task_list[], int index, int row_width, int *length) {
+    reserve_rows(index + 1, row_width);
+    if (!valid[index]) format_row(&task_list[index], index);
+    *length = lengths[index];
+    return text + (size_t)index * ROW_SIZE;
+}
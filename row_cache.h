@@ -0,0 +1,15 @@
+#ifndef ROW_CACHE_H
+#define ROW_CACHE_H
+
+#include "task_manager.h"
+
+// Formatted task-list rows ("12. [x] name"), kept per task and already cut
+// to the pane width, so drawing a row is a copy instead of a printf.  A row
+// is formatted again only after its task changes, a removal renumbers it,
+// or the pane width changes.
+void row_cache_build(Task task_list[], int total_tasks);
+void row_cache_task_changed(Task task_list[], int index);
+void row_cache_task_removed(int index);
+const char *row_cache_task_row(Task task_list[], int index, int width, int *length);
+
+#endif
@@ -0,0 +1,102 @@
+#include "scan_kernel.h"
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SCAN_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+typedef const char *(*ScanFunction)(const char *, size_t, const char *, size_t);
+
+static const char *scan_scalar(const char *haystack, size_t length, const char *needle, size_t needle_length) {
+    const char *end = haystack + length - needle_length + 1;
+    const char *cursor = haystack;
+    while (cursor < end) {
+        cursor = memchr(cursor, needle[0], end - cursor);
+        if (cursor == NULL) return NULL;
+        if (cursor[needle_length - 1] == needle[needle_length - 1] &&
+            memcmp(cursor + 1, needle + 1, needle_length - 1) == 0) {
+            return cursor;
+        }
+        cursor++;
+    }
+    return NULL;
+}
+
+#ifdef SCAN_HAVE_X86
+__attribute__((target("sse2")))
+static const char *scan_sse2(const char *haystack, size_t length, const char *needle, size_t needle_length) {
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needle_length - 1]);
+    size_t positions = length - needle_length + 1;
+    size_t middle = needle_length > 2 ? needle_length - 2 : 0;
+
+    for (size_t i = 0; i < positions; i += 16) {
+        __m128i block_first = _mm_loadu_si128((const __m128i *)(haystack + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i *)(haystack + i + needle_length - 1));
+        unsigned int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+                                                            _mm_cmpeq_epi8(last, block_last)));
+        while (mask) {
+            size_t candidate = i + __builtin_ctz(mask);
+            if (candidate >= positions) return NULL;
+            if (memcmp(haystack + candidate + 1, needle + 1, middle) == 0) {
+                return haystack + candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return NULL;
+}
+
+__attribute__((target("avx2")))
+static const char *scan_avx2(const char *haystack, size_t length, const char *needle, size_t needle_length) {
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[needle_length - 1]);
+    size_t positions = length - needle_length + 1;
+    size_t middle = needle_length > 2 ? needle_length - 2 : 0;
+
+    for (size_t i = 0; i < positions; i += 32) {
+        __m256i block_first = _mm256_loadu_si256((const __m256i *)(haystack + i));
+        __m256i block_last = _mm256_loadu_si256((const __m256i *)(haystack + i + needle_length - 1));
+        unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first),
+                                                                               _mm256_cmpeq_epi8(last, block_last)));
+        while (mask) {
+            size_t candidate = i + __builtin_ctz(mask);
+            if (candidate >= positions) return NULL;
+            if (memcmp(haystack + candidate + 1, needle + 1, middle) == 0) {
+                return haystack + candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return NULL;
+}
+#endif
+
+static ScanFunction scan_implementation = NULL;
+static const char *implementation_name = "scalar";
+
+static void select_implementation(void) {
+    scan_implementation = scan_scalar;
+#ifdef SCAN_HAVE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        scan_implementation = scan_avx2;
+        implementation_name = "avx2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        scan_implementation = scan_sse2;
+        implementation_name = "sse2";
+    }
+#endif
+}
+
+const char *scan_find(const char *haystack, size_t length, const char *needle, size_t needle_length) {
+    if (needle_length == 0 || needle_length > length) return NULL;
+    if (scan_implementation == NULL) select_implementation();
+    return scan_implementation(haystack, length, needle, needle_length);
+}
+
+const char *scan_kernel_name(void) {
+    if (scan_implementation == NULL) select_implementation();
+    return implementation_name;
+}
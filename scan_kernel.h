@@ -0,0 +1,17 @@
+#ifndef SCAN_KERNEL_H
+#define SCAN_KERNEL_H
+
+#include <stddef.h>
+
+// Bytes that must be readable past the end of any haystack passed to
+// scan_find, so the vector loops never need a scalar tail.
+#define SCAN_PADDING 32
+
+// memmem-style search for needle in haystack.  Candidates are filtered on
+// the needle's first and last byte 16 (SSE2) or 32 (AVX2) positions at a
+// time; the implementation is picked once from the running CPU, with a
+// scalar fallback elsewhere.
+const char *scan_find(const char *haystack, size_t length, const char *needle, size_t needle_length);
+const char *scan_kernel_name(void);
+
+#endif
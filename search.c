@@ -0,0 +1,212 @@
+#include "search.h"
+#include "search_index.h"
+#include "trigram_index.h"
+#include "fuzzy.h"
+#include "text_arena.h"
+#include "text_fold.h"
+#include "render.h"
+#include "perf.h"
+#include <ncurses.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_QUERY_LENGTH 100
+#define MAX_TERMS 16
+
+static SearchHit *matches = NULL;
+static int match_count = 0;
+static int match_capacity = 0;
+static int position = 0;
+
+// Folded, since that is the text matching runs on.
+static char last_query[MAX_QUERY_LENGTH] = "";
+static bool can_narrow = false;
+static bool fuzzy_mode = false;
+
+static int split_terms(const char *folded, char *buffer, char *terms[]) {
+    int term_count = 0;
+    strcpy(buffer, folded);
+
+    char *cursor = buffer;
+    while (*cursor && term_count < MAX_TERMS) {
+        while (*cursor == ' ') *cursor++ = '\0';
+        if (!*cursor) break;
+        terms[term_count++] = cursor;
+        while (*cursor && *cursor != ' ') cursor++;
+    }
+    return term_count;
+}
+
+// Live search runs once per byte typed, so a query can end in the first
+// bytes of a character; its matches are no base to narrow from.
+static bool ends_inside_character(const char *text) {
+    int length = strlen(text);
+    int continuation = 0;
+    while (continuation < length && continuation < 3 && ((unsigned char)text[length - 1 - continuation] & 0xC0) == 0x80) {
+        continuation++;
+    }
+    if (continuation == length) return false;
+    unsigned char lead = text[length - 1 - continuation];
+    int size = lead < 0x80 ? 1 : (lead & 0xE0) == 0xC0 ? 2 : (lead & 0xF0) == 0xE0 ? 3 : (lead & 0xF8) == 0xF0 ? 4 : 1;
+    return continuation + 1 < size;
+}
+
+static int score_task(int task, char *terms[], int term_count) {
+    int score = 0;
+    if (fuzzy_mode) {
+        int length;
+        const char *name = text_arena_name(task, &length);
+        for (int t = 0; t < term_count; t++) {
+            int term_score = fuzzy_score(name, length, terms[t]);
+            if (!term_score) return 0;
+            score += term_score;
+        }
+        return score;
+    }
+
+    for (int t = 0; t < term_count; t++) {
+        int fields = task_match_fields(task, terms[t]);
+        if (!fields) return 0;
+        score += search_field_weight(fields) + 16 * search_field_weight(search_index_token_fields(terms[t], task));
+    }
+    return score;
+}
+
+static int compare_matches(const void *a, const void *b) {
+    const SearchHit *left = a;
+    const SearchHit *right = b;
+    if (left->score != right->score) return right->score - left->score;
+    return left->task - right->task;
+}
+
+static void reserve_matches(int count) {
+    if (count > match_capacity) {
+        match_capacity = count;
+        matches = realloc(matches, match_capacity * sizeof(SearchHit));
+    }
+}
+
+// Runs the query and returns the number of matches, best first in
+// search_match(); nothing is printed, so batch mode uses it as is.
+int search_run(Task task_list[], int total_tasks, const char *query) {
+    (void)task_list;
+    double started = perf_now();
+    char folded[MAX_QUERY_LENGTH];
+    char buffer[MAX_QUERY_LENGTH];
+    char *terms[MAX_TERMS];
+    fold_text(query, folded, MAX_QUERY_LENGTH);
+    int term_count = split_terms(folded, buffer, terms);
+
+    bool narrowing = can_narrow && last_query[0] && strncmp(folded, last_query, strlen(last_query)) == 0;
+    strcpy(last_query, folded);
+    can_narrow = term_count > 0 && !ends_inside_character(folded);
+    position = 0;
+
+    if (term_count == 0) {
+        match_count = 0;
+        return 0;
+    }
+
+    int kept = 0;
+    if (narrowing) {
+        // Every match of the longer query is a match of the shorter one, so
+        // the previous result set is the complete candidate set.
+        for (int i = 0; i < match_count; i++) {
+            int task = matches[i].task;
+            if (task >= total_tasks) continue;
+            int score = score_task(task, terms, term_count);
+            if (score > 0) {
+                matches[kept].task = task;
+                matches[kept++].score = score;
+            }
+        }
+    } else if (fuzzy_mode) {
+        // Subsequences have no trigrams to look up, so fuzzy queries start
+        // from every title; the scorer rejects non-matches in one pass.
+        reserve_matches(total_tasks);
+        for (int task = 0; task < total_tasks; task++) {
+            int score = score_task(task, terms, term_count);
+            if (score > 0) {
+                matches[kept].task = task;
+                matches[kept++].score = score;
+            }
+        }
+    } else {
+        int longest = 0;
+        for (int t = 1; t < term_count; t++) {
+            if (strlen(terms[t]) > strlen(terms[longest])) longest = t;
+        }
+        SearchHit *candidates;
+        int candidate_count = trigram_index_query(total_tasks, terms[longest], &candidates);
+
+        reserve_matches(candidate_count);
+        for (int i = 0; i < candidate_count; i++) {
+            int task = candidates[i].task;
+            int score = score_task(task, terms, term_count);
+            if (score > 0) {
+                matches[kept].task = task;
+                matches[kept++].score = score;
+            }
+        }
+    }
+    match_count = kept;
+    qsort(matches, match_count, sizeof(SearchHit), compare_matches);
+    perf_record(PERF_SEARCH, started);
+    return match_count;
+}
+
+int search_match(int position) {
+    return matches[position].task;
+}
+
+void search_tasks(Task task_list[], int total_tasks, const char *query, int *selected_task_index) {
+    search_run(task_list, total_tasks, query);
+    if (match_count == 0) {
+        mvprintw(status_row, 0, "No tasks match \"%s\".", query);
+    } else {
+        *selected_task_index = matches[0].task;
+        mvprintw(status_row, 0, "Match 1/%d ('n' next, 'N' previous)", match_count);
+    }
+    refresh();
+}
+
+void search_step(int total_tasks, int direction, int *selected_task_index) {
+    if (match_count == 0) {
+        mvprintw(status_row, 0, "No active search. Press '/' to search.");
+        refresh();
+        return;
+    }
+
+    position = (position + direction + match_count) % match_count;
+    if (matches[position].task < total_tasks) {
+        *selected_task_index = matches[position].task;
+    }
+    mvprintw(status_row, 0, "Match %d/%d", position + 1, match_count);
+    refresh();
+}
+
+// Tasks changed since the last query, so the previous matches are no
+// longer a safe candidate set for narrowing.
+void search_invalidate(void) {
+    can_narrow = false;
+}
+
+void search_clear(void) {
+    match_count = 0;
+    position = 0;
+    last_query[0] = '\0';
+    can_narrow = false;
+}
+
+void search_set_fuzzy(bool enabled) {
+    if (enabled != fuzzy_mode) can_narrow = false;
+    fuzzy_mode = enabled;
+}
+
+bool search_is_fuzzy(void) {
+    return fuzzy_mode;
+}
+
+int search_match_count(void) {
+    return match_count;
+}
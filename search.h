@@ -0,0 +1,25 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "task_manager.h"
+
+// A task matches when every space-separated term of the query occurs in
+// it somewhere (case-insensitively).  Matches are ranked by the fields the
+// terms occur in, with whole-word occurrences weighted far above fragments.
+//
+// In fuzzy mode each term instead has to be a subsequence of the task name,
+// scored fzf-style (see fuzzy.h).
+//
+// When the query extends the previous one, only the previous matches are
+// re-checked, which keeps search-as-you-type cheap on large lists.
+int search_run(Task task_list[], int total_tasks, const char *query);
+int search_match(int position);
+void search_tasks(Task task_list[], int total_tasks, const char *query, int *selected_task_index);
+void search_step(int total_tasks, int direction, int *selected_task_index);
+void search_invalidate(void);
+void search_clear(void);
+void search_set_fuzzy(bool enabled);
+bool search_is_fuzzy(void);
+int search_match_count(void);
+
+#endif
@@ -0,0 +1,203 @@
+#include "search_index.h"
+#include "task_ids.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define MAX_TOKEN_LENGTH 50
+
+typedef struct {
+    int task_id;  // see task_ids.h
+    unsigned char fields;
+} Posting;
+
+typedef struct {
+    char *token;
+    Posting *postings;
+    int count;
+    int capacity;
+} TokenEntry;
+
+static TokenEntry *tokens = NULL;
+static int token_count = 0;
+static int token_capacity = 0;
+
+// Open addressing over token ids, stored +1 so that 0 marks an empty slot.
+static int *table = NULL;
+static int table_size = 0;
+
+static TermLists forward = { NULL, 0, 0 };
+
+
+static unsigned int hash_token(const char *token) {
+    unsigned int hash = 2166136261u;
+    while (*token) {
+        hash ^= (unsigned char)*token++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void grow_table(void) {
+    int new_size = table_size ? table_size * 2 : 1024;
+    int *new_table = calloc(new_size, sizeof(int));
+    for (int id = 0; id < token_count; id++) {
+        unsigned int slot = hash_token(tokens[id].token) & (new_size - 1);
+        while (new_table[slot]) slot = (slot + 1) & (new_size - 1);
+        new_table[slot] = id + 1;
+    }
+    free(table);
+    table = new_table;
+    table_size = new_size;
+}
+
+static int find_token(const char *token) {
+    if (table_size == 0) return -1;
+    unsigned int slot = hash_token(token) & (table_size - 1);
+    while (table[slot]) {
+        int id = table[slot] - 1;
+        if (strcmp(tokens[id].token, token) == 0) return id;
+        slot = (slot + 1) & (table_size - 1);
+    }
+    return -1;
+}
+
+static int intern_token(const char *token) {
+    int id = find_token(token);
+    if (id >= 0) return id;
+
+    if ((token_count + 1) * 10 >= table_size * 7) grow_table();
+    if (token_count == token_capacity) {
+        token_capacity = token_capacity ? token_capacity * 2 : 256;
+        tokens = realloc(tokens, token_capacity * sizeof(TokenEntry));
+    }
+    id = token_count++;
+    tokens[id].token = malloc(strlen(token) + 1);
+    strcpy(tokens[id].token, token);
+    tokens[id].postings = NULL;
+    tokens[id].count = 0;
+    tokens[id].capacity = 0;
+
+    unsigned int slot = hash_token(token) & (table_size - 1);
+    while (table[slot]) slot = (slot + 1) & (table_size - 1);
+    table[slot] = id + 1;
+    return id;
+}
+
+// Index of the first posting whose task id is >= task_id.
+static int lower_bound(const TokenEntry *entry, int task_id) {
+    int low = 0, high = entry->count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (entry->postings[mid].task_id < task_id) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+static int next_token(const char **cursor, const char *end, char *out) {
+    const unsigned char *p = (const unsigned char *)*cursor;
+    const unsigned char *stop = (const unsigned char *)end;
+    while (p < stop && !(isalnum(*p) || *p >= 0x80)) p++;
+
+    int length = 0;
+    while (p < stop && (isalnum(*p) || *p >= 0x80)) {
+        if (length < MAX_TOKEN_LENGTH - 1) out[length++] = *p;
+        p++;
+    }
+    out[length] = '\0';
+    *cursor = (const char *)p;
+    return length;
+}
+
+static void add_field(int index, int task_id, const char *text, int text_length, unsigned char field) {
+    char token[MAX_TOKEN_LENGTH];
+    const char *cursor = text;
+    while (next_token(&cursor, text + text_length, token) > 0) {
+        int id = intern_token(token);
+        TokenEntry *entry = &tokens[id];
+        int pos = lower_bound(entry, task_id);
+        if (pos < entry->count && entry->postings[pos].task_id == task_id) {
+            entry->postings[pos].fields |= field;
+            continue;
+        }
+
+        if (entry->count == entry->capacity) {
+            entry->capacity = entry->capacity ? entry->capacity * 2 : 4;
+            entry->postings = realloc(entry->postings, entry->capacity * sizeof(Posting));
+        }
+        memmove(&entry->postings[pos + 1], &entry->postings[pos], (entry->count - pos) * sizeof(Posting));
+        entry->postings[pos].task_id = task_id;
+        entry->postings[pos].fields = field;
+        entry->count++;
+
+        term_list_push(term_lists_at(&forward, index), id);
+    }
+}
+
+static void add_task(int index) {
+    TextSegment segments[TEXT_MAX_SEGMENTS];
+    int count = text_arena_segments(index, segments);
+    term_lists_at(&forward, index);
+    int task_id = task_id_at(index);
+    for (int i = 0; i < count; i++) {
+        add_field(index, task_id, segments[i].text, segments[i].length, segments[i].field);
+    }
+}
+
+static void remove_task(int index) {
+    if (index >= forward.count) return;
+    TermList *list = &forward.lists[index];
+    int task_id = task_id_at(index);
+    for (int i = 0; i < list->count; i++) {
+        TokenEntry *entry = &tokens[list->ids[i]];
+        int pos = lower_bound(entry, task_id);
+        if (pos < entry->count && entry->postings[pos].task_id == task_id) {
+            memmove(&entry->postings[pos], &entry->postings[pos + 1], (entry->count - pos - 1) * sizeof(Posting));
+            entry->count--;
+        }
+    }
+    list->count = 0;
+}
+
+void search_index_build(Task task_list[], int total_tasks) {
+    for (int id = 0; id < token_count; id++) {
+        tokens[id].count = 0;
+    }
+    term_lists_reset(&forward, total_tasks);
+    (void)task_list;
+    for (int i = 0; i < total_tasks; i++) {
+        add_task(i);
+    }
+}
+
+void search_index_task_changed(Task task_list[], int index) {
+    (void)task_list;
+    remove_task(index);
+    add_task(index);
+}
+
+void search_index_task_removed(int index) {
+    remove_task(index);
+    term_lists_removed(&forward, index);
+}
+
+int search_field_weight(int fields) {
+    int weight = 0;
+    if (fields & FIELD_NAME) weight += 8;
+    if (fields & FIELD_CATEGORY) weight += 4;
+    if (fields & FIELD_SUBTASK) weight += 2;
+    if (fields & FIELD_DESCRIPTION) weight += 1;
+    return weight;
+}
+
+// FIELD_* mask of the fields in which task contains token (already folded)
+// as a whole word.
+int search_index_token_fields(const char *token, int task) {
+    int id = find_token(token);
+    if (id < 0) return 0;
+    int task_id = task_id_at(task);
+    int pos = lower_bound(&tokens[id], task_id);
+    if (pos == tokens[id].count || tokens[id].postings[pos].task_id != task_id) return 0;
+    return tokens[id].postings[pos].fields;
+}
@@ -0,0 +1,23 @@
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include "task_manager.h"
+#include "text_arena.h"
+
+typedef struct {
+    int task;
+    int score;
+} SearchHit;
+
+// Token-level inverted index over task names, categories, subtask names and
+// descriptions.  Tokens are runs of letters/digits taken from the folded
+// text in the text arena, which must be updated before this index.
+// search.c finds its candidates with the trigram index and asks this one
+// which fields of a task hold a query word whole, to rank them.
+void search_index_build(Task task_list[], int total_tasks);
+void search_index_task_changed(Task task_list[], int index);
+void search_index_task_removed(int index);
+int search_index_token_fields(const char *token, int task);
+int search_field_weight(int fields);
+
+#endif
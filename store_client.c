@@ -0,0 +1,104 @@
+#define _POSIX_C_SOURCE 200809L
+#include "store_client.h"
+#include "store_protocol.h"
+#include "batch.h"
+#include "perf.h"
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Rows fetched per request when listing the whole store.
+#define LIST_SLICE 64
+
+int store_connect(const char *socket_path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address.sun_path)) return -1;
+    strcpy(address.sun_path, socket_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Sends a request and reads its response, with up to reply_size bytes of
+// payload into reply.  False if the daemon is gone.
+static bool store_request(int server, StoreRequestType type, int first, int count, const char *payload,
+                          StoreResponse *response, void *reply, size_t reply_size) {
+    StoreRequest request = { type, first, count, payload ? strlen(payload) : 0 };
+    if (request.length > STORE_MAX_PAYLOAD) request.length = STORE_MAX_PAYLOAD;
+    if (!store_write(server, &request, sizeof(request)) || !store_write(server, payload, request.length)) return false;
+    if (!store_read(server, response, sizeof(StoreResponse))) return false;
+    if (response->length > reply_size) return false;
+    return store_read(server, reply, response->length);
+}
+
+static void print_rows(const StoreRow rows[], int count) {
+    for (int i = 0; i < count; i++) {
+        batch_print_row(rows[i].index, rows[i].is_completed, rows[i].name, rows[i].priority, rows[i].deadline);
+    }
+}
+
+// Runs one command line; false if the connection was lost.
+static bool run_remote_command(int server, char *line, int *error_count, int line_number) {
+    static StoreRow rows[MAX_TASKS];
+    StoreResponse response;
+    char *command = line + strspn(line, " ");
+    int command_length = strcspn(command, " ");
+    char *rest = command + command_length;
+    rest += strspn(rest, " ");
+
+    if (command_length == 4 && strncmp(command, "list", 4) == 0) {
+        int first = 0;
+        do {
+            if (!store_request(server, STORE_LIST, first, LIST_SLICE, NULL, &response, rows, sizeof(rows))) return false;
+            print_rows(rows, response.count);
+            first += response.count;
+        } while (response.count > 0 && first < response.total);
+    } else if (command_length == 6 && strncmp(command, "search", 6) == 0) {
+        if (!store_request(server, STORE_QUERY, 0, 0, rest, &response, rows, sizeof(rows))) return false;
+        print_rows(rows, response.count);
+        printf("%d match(es) for \"%s\"\n", response.count, rest);
+    } else {
+        if (!store_request(server, STORE_COMMAND, 0, 0, command, &response, NULL, 0)) return false;
+        if (response.status == STORE_REFUSED) {
+            fprintf(stderr, "line %d: \"%.*s\" is unknown or not run by the daemon\n", line_number, command_length, command);
+            (*error_count)++;
+        } else if (response.status != TASK_OK) {
+            fprintf(stderr, "line %d: %s\n", line_number, task_status_message(response.status));
+            (*error_count)++;
+        }
+    }
+    return true;
+}
+
+int run_remote_batch(FILE *input, int server) {
+    char line[512];
+    int line_number = 0;
+    int command_count = 0;
+    int error_count = 0;
+    double started = perf_now();
+
+    while (fgets(line, sizeof(line), input)) {
+        line_number++;
+        line[strcspn(line, "\r\n")] = '\0';
+        char *command = line + strspn(line, " ");
+        if (!*command || *command == '#') continue;
+
+        command_count++;
+        if (!run_remote_command(server, line, &error_count, line_number)) {
+            fprintf(stderr, "line %d: lost the connection to the daemon\n", line_number);
+            error_count++;
+            break;
+        }
+    }
+
+    fprintf(stderr, "%d command(s), %d error(s) in %.3f ms\n", command_count, error_count, perf_now() - started);
+    return error_count;
+}
@@ -0,0 +1,14 @@
+#ifndef STORE_CLIENT_H
+#define STORE_CLIENT_H
+
+#include <stdio.h>
+
+// The client side of store_protocol.h.  store_connect returns the socket,
+// or -1 if no daemon listens on socket_path.
+int store_connect(const char *socket_path);
+
+// run_batch against a daemon: the same commands and output, but the list
+// stays in the daemon and only the rows printed are fetched.
+int run_remote_batch(FILE *input, int server);
+
+#endif
@@ -0,0 +1,28 @@
+#define _POSIX_C_SOURCE 200809L
+#include "store_protocol.h"
+#include <errno.h>
+#include <unistd.h>
+
+bool store_read(int fd, void *buffer, size_t size) {
+    char *cursor = buffer;
+    while (size > 0) {
+        ssize_t done = read(fd, cursor, size);
+        if (done < 0 && errno == EINTR) continue;
+        if (done <= 0) return false;
+        cursor += done;
+        size -= done;
+    }
+    return true;
+}
+
+bool store_write(int fd, const void *buffer, size_t size) {
+    const char *cursor = buffer;
+    while (size > 0) {
+        ssize_t done = write(fd, cursor, size);
+        if (done < 0 && errno == EINTR) continue;
+        if (done <= 0) return false;
+        cursor += done;
+        size -= done;
+    }
+    return true;
+}
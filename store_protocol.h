@@ -0,0 +1,72 @@
+#ifndef STORE_PROTOCOL_H
+#define STORE_PROTOCOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "task_core.h"
+
+// Where todo --daemon listens unless told otherwise; relative like
+// tasks.json, so each directory has its own store.
+#define STORE_SOCKET "todo.sock"
+#define STORE_MAX_PAYLOAD 512
+// Status of a request the daemon does not serve.
+#define STORE_REFUSED -1
+
+// Every request is a StoreRequest followed by length bytes of payload,
+// every reply a StoreResponse followed by length bytes.  Both ends are
+// the same binary on the same machine, so the structs go over the socket
+// as they are laid out in memory.
+//
+//   STORE_LIST       rows first..first+count-1 as StoreRow
+//   STORE_GET        task first as a whole Task
+//   STORE_COMMAND    payload is one batch command that changes the store
+//                    (see batch.h; not list, search, load or save FILE);
+//                    status is its TaskStatus, STORE_REFUSED for any other
+//   STORE_QUERY      payload is a search query; its matches as StoreRow,
+//                    best first
+//   STORE_SUBSCRIBE  turns the connection into a subscription: after the
+//                    reply, a STORE_SUBSCRIBE response with no payload
+//                    arrives whenever the store has changed, and nothing
+//                    else.  Sending another request closes it, so
+//                    subscribers use a connection of their own.
+typedef enum {
+    STORE_LIST = 1,
+    STORE_GET,
+    STORE_COMMAND,
+    STORE_QUERY,
+    STORE_SUBSCRIBE
+} StoreRequestType;
+
+typedef struct {
+    uint32_t type;
+    int32_t first;
+    int32_t count;
+    uint32_t length;
+} StoreRequest;
+
+typedef struct {
+    uint32_t type;
+    int32_t status;
+    // Tasks in the store, and how many times it has changed.
+    int32_t total;
+    uint32_t generation;
+    uint32_t count;
+    uint32_t length;
+} StoreResponse;
+
+// What the task pane shows of a task.
+typedef struct {
+    int32_t index;
+    uint8_t is_completed;
+    uint8_t priority;
+    char deadline[11];
+    char name[50];
+} StoreRow;
+
+// Whole-buffer reads and writes that ride out short transfers and
+// signals; false on end of file or error.
+bool store_read(int fd, void *buffer, size_t size);
+bool store_write(int fd, const void *buffer, size_t size);
+
+#endif
@@ -0,0 +1,372 @@
+#define _POSIX_C_SOURCE 200809L
+#include "store_server.h"
+#include "store_protocol.h"
+#include "batch.h"
+#include "search.h"
+#include "file_watch.h"
+#include "perf.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define MAX_CLIENTS 16
+// How long the store has to be left alone before changes are saved.
+#define SAVE_DELAY_MS 1000
+// How long tasks.json has to stay quiet after a write before it is
+// merged, as file_watch does for the TUI.
+#define SETTLE_MS 50
+
+// The largest reply: a full STORE_LIST or STORE_QUERY, or a STORE_GET.
+#define REPLY_SIZE (sizeof(StoreResponse) + sizeof(StoreRow) * MAX_TASKS + sizeof(Task))
+
+// Clients are non-blocking: a request is served once it has arrived in
+// full, and its reply is sent as the client takes it.  No more requests
+// are read from a client until it has taken the last reply, so a slow
+// client holds up only itself.
+typedef struct {
+    int fd;
+    bool is_subscribed;
+    char input[sizeof(StoreRequest) + STORE_MAX_PAYLOAD];
+    size_t input_length;
+    char output[REPLY_SIZE];
+    size_t output_length;
+    size_t output_sent;
+} Client;
+
+// The batch commands that change the store.  list and search print on
+// stdout, so clients use STORE_LIST and STORE_QUERY instead; load and
+// save FILE would let any client read or write any file the daemon can.
+static const char *const store_commands[] = {
+    "add", "name", "describe", "deadline", "categories", "toggle",
+    "delete", "priority", "subtask", "sort", "save"
+};
+
+static Task *store_tasks;
+static int *store_total;
+static const char *store_file;
+static uint32_t generation = 0;
+static bool is_dirty = false;
+static bool has_news = false;
+// The file was written by someone else (a TUI, or todo --batch run with
+// no daemon) and is merged once it has settled, at merge_time.
+static bool is_merge_due = false;
+static double merge_time = 0;
+
+static Client clients[MAX_CLIENTS];
+static int client_count = 0;
+static StoreRow rows[MAX_TASKS];
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void request_stop(int signal_number) {
+    (void)signal_number;
+    stop_requested = 1;
+}
+
+// Sends what the client will take of its reply; false if it has gone.
+static bool flush_client(Client *client) {
+    while (client->output_sent < client->output_length) {
+        ssize_t done = write(client->fd, client->output + client->output_sent,
+                             client->output_length - client->output_sent);
+        if (done < 0 && errno == EINTR) continue;
+        if (done < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+        if (done <= 0) return false;
+        client->output_sent += done;
+    }
+    client->output_length = 0;
+    client->output_sent = 0;
+    return true;
+}
+
+static bool respond(Client *client, uint32_t type, int status, const void *payload, int count, size_t length) {
+    StoreResponse response = { type, status, *store_total, generation, count, length };
+    memcpy(client->output, &response, sizeof(response));
+    if (length > 0) memcpy(client->output + sizeof(response), payload, length);
+    client->output_length = sizeof(response) + length;
+    client->output_sent = 0;
+    return flush_client(client);
+}
+
+static bool is_store_command(const char *line) {
+    const char *command = line + strspn(line, " ");
+    size_t length = strcspn(command, " ");
+    for (size_t i = 0; i < sizeof(store_commands) / sizeof(store_commands[0]); i++) {
+        if (strlen(store_commands[i]) == length && strncmp(command, store_commands[i], length) == 0) {
+            // save FILE writes wherever it is told to.
+            return length != 4 || strncmp(command, "save", 4) != 0 || command[4 + strspn(command + 4, " ")] == '\0';
+        }
+    }
+    return false;
+}
+
+// Runs a command and tells whether the store came out different: a
+// command can fail halfway, and sort or save may change nothing.
+static bool run_store_command(char *line, TaskStatus *status) {
+    static unsigned int before[MAX_TASKS];
+    int before_total = *store_total;
+    for (int i = 0; i < before_total; i++) {
+        before[i] = task_hash(&store_tasks[i]);
+    }
+    run_batch_command(line, store_tasks, store_total, store_file, status);
+    bool changed = *store_total != before_total;
+    for (int i = 0; i < *store_total && !changed; i++) {
+        changed = task_hash(&store_tasks[i]) != before[i];
+    }
+    return changed;
+}
+
+static void fill_row(StoreRow *row, int index) {
+    Task *task = &store_tasks[index];
+    row->index = index;
+    row->is_completed = task->is_completed;
+    row->priority = task->priority;
+    memcpy(row->deadline, task->deadline, sizeof(row->deadline));
+    memcpy(row->name, task->name, sizeof(row->name));
+}
+
+// Answers one request; false when the client has gone or broke the
+// protocol and should be dropped.
+static bool handle_request(Client *client, const StoreRequest *message, const char *body) {
+    StoreRequest request = *message;
+    char payload[STORE_MAX_PAYLOAD + 1];
+    memcpy(payload, body, request.length);
+    payload[request.length] = '\0';
+
+    switch (request.type) {
+        case STORE_LIST: {
+            int first = request.first < 0 ? 0 : request.first;
+            int count = request.count;
+            if (count > *store_total - first) count = *store_total - first;
+            if (count < 0) count = 0;
+            for (int i = 0; i < count; i++) {
+                fill_row(&rows[i], first + i);
+            }
+            return respond(client, request.type, TASK_OK, rows, count, count * sizeof(StoreRow));
+        }
+        case STORE_GET:
+            if (request.first < 0 || request.first >= *store_total) {
+                return respond(client, request.type, TASK_NO_SUCH_TASK, NULL, 0, 0);
+            }
+            return respond(client, request.type, TASK_OK, &store_tasks[request.first], 1, sizeof(Task));
+        case STORE_COMMAND: {
+            TaskStatus status;
+            if (!is_store_command(payload)) {
+                return respond(client, request.type, STORE_REFUSED, NULL, 0, 0);
+            }
+            if (run_store_command(payload, &status)) {
+                generation++;
+                is_dirty = true;
+                has_news = true;
+            }
+            return respond(client, request.type, status, NULL, 0, 0);
+        }
+        case STORE_QUERY: {
+            int count = search_run(store_tasks, *store_total, payload);
+            for (int i = 0; i < count; i++) {
+                fill_row(&rows[i], search_match(i));
+            }
+            return respond(client, request.type, TASK_OK, rows, count, count * sizeof(StoreRow));
+        }
+        case STORE_SUBSCRIBE:
+            client->is_subscribed = true;
+            return respond(client, request.type, TASK_OK, NULL, 0, 0);
+    }
+    return respond(client, request.type, STORE_REFUSED, NULL, 0, 0);
+}
+
+// Serves the requests that have arrived in full, as long as the client
+// keeps taking the replies; false when it should be dropped.
+static bool serve_client(Client *client) {
+    StoreRequest request;
+    while (client->output_length == 0 && client->input_length >= sizeof(request)) {
+        memcpy(&request, client->input, sizeof(request));
+        if (request.length > STORE_MAX_PAYLOAD) return false;
+        size_t size = sizeof(request) + request.length;
+        if (client->input_length < size) break;
+        // A subscription connection only listens.
+        if (client->is_subscribed) return false;
+        if (!handle_request(client, &request, client->input + sizeof(request))) return false;
+        client->input_length -= size;
+        memmove(client->input, client->input + size, client->input_length);
+    }
+    return true;
+}
+
+static bool read_client(Client *client) {
+    ssize_t done = read(client->fd, client->input + client->input_length,
+                        sizeof(client->input) - client->input_length);
+    if (done < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+    if (done <= 0) return false;
+    client->input_length += done;
+    return serve_client(client);
+}
+
+static void drop_client(int position) {
+    close(clients[position].fd);
+    clients[position] = clients[--client_count];
+}
+
+// A subscriber that has not taken the last notice yet is not sent
+// another: the one waiting already says the store changed.
+static void notify_subscribers(void) {
+    for (int i = client_count - 1; i >= 0; i--) {
+        if (!clients[i].is_subscribed || clients[i].output_length > 0) continue;
+        if (!respond(&clients[i], STORE_SUBSCRIBE, TASK_OK, NULL, 0, 0)) drop_client(i);
+    }
+    has_news = false;
+}
+
+static void save_store(void) {
+    if (tasks_sync(store_tasks, store_total, store_file, NULL) != TASK_OK) {
+        fprintf(stderr, "todo daemon: could not save %s\n", store_file);
+    }
+    is_dirty = false;
+}
+
+static void merge_file(void) {
+    MergeResult result;
+    TaskStatus status = tasks_merge(store_tasks, store_total, store_file, NULL, &result);
+    if (status == TASK_LIST_FULL) {
+        fprintf(stderr, "todo daemon: merging %s would go over %d tasks; not merged\n", store_file, MAX_TASKS);
+    } else if (status == TASK_OK && result.changed) {
+        generation++;
+        has_news = true;
+    }
+    is_merge_due = false;
+}
+
+static int open_listener(const char *socket_path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "todo daemon: socket path too long: %s\n", socket_path);
+        return -1;
+    }
+    strcpy(address.sun_path, socket_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    // A socket left behind by a daemon that died is replaced; one that a
+    // live daemon answers on is not.
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) == 0) {
+        fprintf(stderr, "todo daemon: already running on %s\n", socket_path);
+        close(fd);
+        return -1;
+    }
+    unlink(socket_path);
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0 || listen(fd, MAX_CLIENTS) < 0) {
+        perror(socket_path);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int run_store_server(const char *socket_path, Task task_list[], int *total_tasks, const char *filename) {
+    store_tasks = task_list;
+    store_total = total_tasks;
+    store_file = filename;
+    if (tasks_load(task_list, total_tasks, filename) != TASK_OK) {
+        fprintf(stderr, "todo daemon: %s not found, starting empty\n", filename);
+    }
+
+    int listener = open_listener(socket_path);
+    if (listener < 0) return 1;
+    int watch = file_watch_open(filename);
+    if (watch < 0) {
+        fprintf(stderr, "todo daemon: cannot watch %s; changes saved by others will not be seen\n", filename);
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = request_stop;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &action, NULL);
+    fprintf(stderr, "todo daemon: serving %s on %s\n", filename, socket_path);
+
+    while (!stop_requested) {
+        // The listener, the file watch (ignored by poll if there is none)
+        // and then the clients.
+        struct pollfd fds[MAX_CLIENTS + 2];
+        fds[0].fd = listener;
+        fds[0].events = POLLIN;
+        fds[1].fd = watch;
+        fds[1].events = POLLIN;
+        for (int i = 0; i < client_count; i++) {
+            fds[i + 2].fd = clients[i].fd;
+            fds[i + 2].events = clients[i].output_length > 0 ? POLLOUT : POLLIN;
+        }
+        int count = client_count;
+        int timeout = is_dirty ? SAVE_DELAY_MS : -1;
+        if (is_merge_due) {
+            timeout = merge_time > perf_now() ? (int)(merge_time - perf_now()) + 1 : 0;
+        }
+        int ready = poll(fds, count + 2, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+        if (is_merge_due && perf_now() >= merge_time) {
+            merge_file();
+            if (has_news) notify_subscribers();
+            continue;
+        }
+        if (ready == 0) {
+            if (is_dirty && !is_merge_due) save_store();
+            continue;
+        }
+        if ((fds[1].revents & POLLIN) && file_watch_read(watch)) {
+            is_merge_due = true;
+            merge_time = perf_now() + SETTLE_MS;
+        }
+
+        // Backwards, so dropping a client (which moves the last one into
+        // its slot) leaves the ones still to be served in place.
+        for (int i = count - 1; i >= 0; i--) {
+            short revents = fds[i + 2].revents;
+            bool is_alive = true;
+            if (revents & (POLLERR | POLLNVAL)) {
+                is_alive = false;
+            } else if (revents & POLLOUT) {
+                is_alive = flush_client(&clients[i]) && serve_client(&clients[i]);
+            } else if (revents & (POLLIN | POLLHUP)) {
+                is_alive = read_client(&clients[i]);
+            }
+            if (!is_alive) drop_client(i);
+        }
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listener, NULL, NULL);
+            if (fd >= 0 && client_count < MAX_CLIENTS && fcntl(fd, F_SETFL, O_NONBLOCK) == 0) {
+                Client *client = &clients[client_count++];
+                client->fd = fd;
+                client->is_subscribed = false;
+                client->input_length = 0;
+                client->output_length = 0;
+                client->output_sent = 0;
+            } else if (fd >= 0) {
+                close(fd);
+            }
+        }
+        if (has_news) notify_subscribers();
+    }
+
+    if (is_dirty) save_store();
+    while (client_count > 0) drop_client(0);
+    if (watch >= 0) close(watch);
+    close(listener);
+    unlink(socket_path);
+    return 0;
+}
@@ -0,0 +1,15 @@
+#ifndef STORE_SERVER_H
+#define STORE_SERVER_H
+
+#include "task_core.h"
+
+// todo --daemon: keeps the task list in memory and serves it over a Unix
+// socket (see store_protocol.h) to todo --batch.  It is not the only
+// writer: the TUI and batch runs started with no daemon save tasks.json
+// themselves, so the daemon watches the file and merges what they save
+// (tasks_merge), telling subscribers as for any other change.  Its own
+// changes are saved with tasks_sync once the store has been idle for a
+// second, and on SIGINT or SIGTERM.  Returns the exit status.
+int run_store_server(const char *socket_path, Task task_list[], int *total_tasks, const char *filename);
+
+#endif
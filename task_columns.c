@@ -0,0 +1,44 @@
+#include "task_columns.h"
+#include <stdlib.h>
+#include <string.h>
+
+TaskColumns task_columns = { NULL, NULL, NULL, 0, 0 };
+
+static void reserve_rows(int count) {
+    if (count <= task_columns.capacity) return;
+    int new_capacity = task_columns.capacity ? task_columns.capacity : 128;
+    while (new_capacity < count) new_capacity *= 2;
+    task_columns.priority = realloc(task_columns.priority, new_capacity * sizeof(int));
+    task_columns.due_day = realloc(task_columns.due_day, new_capacity * sizeof(int));
+    task_columns.is_completed = realloc(task_columns.is_completed, new_capacity);
+    task_columns.capacity = new_capacity;
+}
+
+static void fill_row(Task *task, int index) {
+    task_columns.priority[index] = task->priority;
+    task_columns.due_day[index] = date_to_day_number(task->deadline);
+    task_columns.is_completed[index] = task->is_completed;
+}
+
+void task_columns_build(Task task_list[], int total_tasks) {
+    reserve_rows(total_tasks);
+    for (int i = 0; i < total_tasks; i++) {
+        fill_row(&task_list[i], i);
+    }
+    task_columns.count = total_tasks;
+}
+
+void task_columns_task_changed(Task task_list[], int index) {
+    reserve_rows(index + 1);
+    fill_row(&task_list[index], index);
+    if (index >= task_columns.count) task_columns.count = index + 1;
+}
+
+void task_columns_task_removed(int index) {
+    if (index >= task_columns.count) return;
+    int tail = task_columns.count - index - 1;
+    memmove(&task_columns.priority[index], &task_columns.priority[index + 1], tail * sizeof(int));
+    memmove(&task_columns.due_day[index], &task_columns.due_day[index + 1], tail * sizeof(int));
+    memmove(&task_columns.is_completed[index], &task_columns.is_completed[index + 1], tail);
+    task_columns.count--;
+}
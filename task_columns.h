@@ -0,0 +1,24 @@
+#ifndef TASK_COLUMNS_H
+#define TASK_COLUMNS_H
+
+#include "task_manager.h"
+
+// Column copies of the fields that filters compare on, one dense array
+// per field, so scans over thousands of tasks do not drag whole 3 KB Task
+// records through the cache.  due_day holds date_to_day_number() of the
+// deadline, -1 when the task has none.
+typedef struct {
+    int *priority;
+    int *due_day;
+    unsigned char *is_completed;
+    int count;
+    int capacity;
+} TaskColumns;
+
+extern TaskColumns task_columns;
+
+void task_columns_build(Task task_list[], int total_tasks);
+void task_columns_task_changed(Task task_list[], int index);
+void task_columns_task_removed(int index);
+
+#endif
@@ -0,0 +1,593 @@
+#define _DEFAULT_SOURCE
+#include "task_core.h"
+#include "task_events.h"
+#include "perf.h"
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+int is_valid_date_format(const char *date) {
+    if (strlen(date) != 10) return 0;
+
+    if (!isdigit(date[0]) || !isdigit(date[1]) || date[2] != '/' ||
+        !isdigit(date[3]) || !isdigit(date[4]) || date[5] != '/' ||
+        !isdigit(date[6]) || !isdigit(date[7]) ||
+        !isdigit(date[8]) || !isdigit(date[9])) {
+        return 0;
+    }
+
+    int day = (date[0] - '0') * 10 + (date[1] - '0');
+    int month = (date[3] - '0') * 10 + (date[4] - '0');
+    int year = (date[6] - '0') * 1000 + (date[7] - '0') * 100 +
+               (date[8] - '0') * 10 + (date[9] - '0');
+
+    if (day < 1 || day > 31 || month < 1 || month > 12 || year < 1) {
+        return 0;
+    }
+
+    return 1;
+}
+
+// Days since a fixed epoch, so deadlines compare and subtract as plain ints.
+// Returns -1 for anything that is not a valid DD/MM/YYYY date.
+int date_to_day_number(const char *date) {
+    if (!is_valid_date_format(date)) return -1;
+
+    int day = (date[0] - '0') * 10 + (date[1] - '0');
+    int month = (date[3] - '0') * 10 + (date[4] - '0');
+    int year = (date[6] - '0') * 1000 + (date[7] - '0') * 100 +
+               (date[8] - '0') * 10 + (date[9] - '0');
+
+    if (month <= 2) {
+        year--;
+        month += 12;
+    }
+    return 365 * year + year / 4 - year / 100 + year / 400 + (153 * (month - 3) + 2) / 5 + day - 1;
+}
+
+int today_day_number(void) {
+    time_t now = time(NULL);
+    struct tm *local = localtime(&now);
+    char today[11];
+    strftime(today, sizeof(today), "%d/%m/%Y", local);
+    return date_to_day_number(today);
+}
+
+// Comma-separated names into categories; returns how many, or -1 if there
+// are more than fit or one is too long.
+int parse_categories(const char *value, char categories[10][30]) {
+    int count = 0;
+    while (*value) {
+        while (*value == ' ' || *value == ',') value++;
+        if (!*value) break;
+        const char *end = value;
+        while (*end && *end != ',') end++;
+        int length = end - value;
+        while (length > 0 && value[length - 1] == ' ') length--;
+        if (count == MAX_CATEGORIES || length > 29) return -1;
+        memcpy(categories[count], value, length);
+        categories[count][length] = '\0';
+        count++;
+        value = end;
+    }
+    return count;
+}
+
+const char *task_status_message(TaskStatus status) {
+    switch (status) {
+        case TASK_OK: return "Done.";
+        case TASK_LIST_FULL: return "Task limit reached. Cannot add more tasks.";
+        case TASK_NO_SUCH_TASK: return "No such task.";
+        case TASK_NO_SUCH_SUBTASK: return "No such subtask.";
+        case TASK_SUBTASKS_FULL: return "Subtask limit reached. Cannot add more subtasks.";
+        case TASK_EMPTY_NAME: return "The name cannot be empty.";
+        case TASK_BAD_DEADLINE: return "Deadline must be a date as DD/MM/YYYY.";
+        case TASK_BAD_PRIORITY: return "Priority must be a number from 1 to 9.";
+        case TASK_BAD_CATEGORIES: return "At most 10 categories of up to 29 characters.";
+        case TASK_FILE_ERROR: return "Could not open the file.";
+    }
+    return "Unknown error.";
+}
+
+static bool is_blank(const char *text) {
+    for (; *text; text++) {
+        if (*text != ' ') return false;
+    }
+    return true;
+}
+
+TaskStatus task_add(Task task_list[], int *total_tasks, const char *name, const char *categories, const char *deadline, const char *description, int priority) {
+    if (*total_tasks >= MAX_TASKS) return TASK_LIST_FULL;
+    if (is_blank(name)) return TASK_EMPTY_NAME;
+    if (!is_valid_date_format(deadline)) return TASK_BAD_DEADLINE;
+    if (priority < 1 || priority > 9) return TASK_BAD_PRIORITY;
+
+    Task task;
+    memset(&task, 0, sizeof(Task));
+    task.category_count = parse_categories(categories, task.categories);
+    if (task.category_count < 0) return TASK_BAD_CATEGORIES;
+    snprintf(task.name, sizeof(task.name), "%s", name);
+    snprintf(task.deadline, sizeof(task.deadline), "%s", deadline);
+    snprintf(task.description, sizeof(task.description), "%s", description);
+    task.priority = priority;
+
+    task_list[(*total_tasks)++] = task;
+    notify_task_added(task_list, *total_tasks - 1);
+    return TASK_OK;
+}
+
+TaskStatus task_delete(Task task_list[], int *total_tasks, int index) {
+    if (index < 0 || index >= *total_tasks) return TASK_NO_SUCH_TASK;
+
+    for (int i = index; i < *total_tasks - 1; i++) {
+        task_list[i] = task_list[i + 1];
+    }
+    (*total_tasks)--;
+    notify_task_removed(task_list, *total_tasks, index);
+    return TASK_OK;
+}
+
+// indexes must be ascending.  The kept tasks are moved down in a single
+// stable pass and the indexes rebuilt once, instead of shifting the tail
+// of the list and renumbering every index for each task removed.
+TaskStatus task_delete_many(Task task_list[], int *total_tasks, const int indexes[], int count) {
+    for (int i = 0; i < count; i++) {
+        if (indexes[i] < 0 || indexes[i] >= *total_tasks) return TASK_NO_SUCH_TASK;
+        if (i > 0 && indexes[i] <= indexes[i - 1]) return TASK_NO_SUCH_TASK;
+    }
+    if (count == 0) return TASK_OK;
+
+    int kept = indexes[0];
+    int next = 0;
+    for (int i = indexes[0]; i < *total_tasks; i++) {
+        if (next < count && indexes[next] == i) {
+            next++;
+        } else {
+            if (kept != i) task_list[kept] = task_list[i];
+            kept++;
+        }
+    }
+    *total_tasks = kept;
+    notify_tasks_reloaded(task_list, *total_tasks);
+    return TASK_OK;
+}
+
+TaskStatus task_set_name(Task task_list[], int total_tasks, int index, const char *name) {
+    if (index < 0 || index >= total_tasks) return TASK_NO_SUCH_TASK;
+    if (is_blank(name)) return TASK_EMPTY_NAME;
+
+    snprintf(task_list[index].name, sizeof(task_list[index].name), "%s", name);
+    notify_task_changed(task_list, index);
+    return TASK_OK;
+}
+
+TaskStatus task_set_description(Task task_list[], int total_tasks, int index, const char *description) {
+    if (index < 0 || index >= total_tasks) return TASK_NO_SUCH_TASK;
+
+    snprintf(task_list[index].description, sizeof(task_list[index].description), "%s", description);
+    notify_task_changed(task_list, index);
+    return TASK_OK;
+}
+
+TaskStatus task_set_deadline(Task task_list[], int total_tasks, int index, const char *deadline) {
+    if (index < 0 || index >= total_tasks) return TASK_NO_SUCH_TASK;
+    if (!is_valid_date_format(deadline)) return TASK_BAD_DEADLINE;
+
+    snprintf(task_list[index].deadline, sizeof(task_list[index].deadline), "%s", deadline);
+    notify_task_changed(task_list, index);
+    return TASK_OK;
+}
+
+TaskStatus task_set_categories(Task task_list[], int total_tasks, int index, const char *categories) {
+    if (index < 0 || index >= total_tasks) return TASK_NO_SUCH_TASK;
+
+    char parsed[10][30];
+    int count = parse_categories(categories, parsed);
+    if (count < 0) return TASK_BAD_CATEGORIES;
+    memcpy(task_list[index].categories, parsed, sizeof(parsed));
+    task_list[index].category_count = count;
+    notify_task_changed(task_list, index);
+    return TASK_OK;
+}
+
+// Adds the comma-separated categories the task does not have yet.
+TaskStatus task_add_categories(Task task_list[], int total_tasks, int index, const char *categories) {
+    if (index < 0 || index >= total_tasks) return TASK_NO_SUCH_TASK;
+
+    char parsed[10][30];
+    int count = parse_categories(categories, parsed);
+    if (count < 0) return TASK_BAD_CATEGORIES;
+
+    Task *task = &task_list[index];
+    char merged[10][30];
+    int merged_count = task->category_count;
+    memcpy(merged, task->categories, sizeof(merged));
+    for (int i = 0; i < count; i++) {
+        bool present = false;
+        for (int j = 0; j < merged_count && !present; j++) {
+            present = strcmp(merged[j], parsed[i]) == 0;
+        }
+        if (present) continue;
+        if (merged_count == MAX_CATEGORIES) return TASK_BAD_CATEGORIES;
+        memcpy(merged[merged_count++], parsed[i], sizeof(parsed[i]));
+    }
+    if (merged_count == task->category_count) return TASK_OK;
+
+    memcpy(task->categories, merged, sizeof(merged));
+    task->category_count = merged_count;
+    notify_task_changed(task_list, index);
+    return TASK_OK;
+}
+
+TaskStatus task_set_priority(Task task_list[], int total_tasks, int index, int priority) {
+    if (index < 0 || index >= total_tasks) return TASK_NO_SUCH_TASK;
+    if (priority < 1 || priority > 9) return TASK_BAD_PRIORITY;
+
+    task_list[index].priority = priority;
+    notify_task_changed(task_list, index);
+    return TASK_OK;
+}
+
+TaskStatus task_toggle(Task task_list[], int total_tasks, int index) {
+    if (index < 0 || index >= total_tasks) return TASK_NO_SUCH_TASK;
+
+    task_list[index].is_completed = !task_list[index].is_completed;
+    notify_task_changed(task_list, index);
+    return TASK_OK;
+}
+
+TaskStatus task_add_subtask(Task task_list[], int total_tasks, int index, const char *name) {
+    if (index < 0 || index >= total_tasks) return TASK_NO_SUCH_TASK;
+    Task *task = &task_list[index];
+    if (task->subtask_count >= MAX_SUBTASKS) return TASK_SUBTASKS_FULL;
+    if (is_blank(name)) return TASK_EMPTY_NAME;
+
+    Subtask *new_subtask = &task->subtasks[task->subtask_count++];
+    snprintf(new_subtask->name, sizeof(new_subtask->name), "%s", name);
+    new_subtask->is_completed = false;
+    notify_task_changed(task_list, index);
+    return TASK_OK;
+}
+
+TaskStatus task_delete_subtask(Task task_list[], int total_tasks, int index, int subtask) {
+    if (index < 0 || index >= total_tasks) return TASK_NO_SUCH_TASK;
+    Task *task = &task_list[index];
+    if (subtask < 0 || subtask >= task->subtask_count) return TASK_NO_SUCH_SUBTASK;
+
+    for (int i = subtask; i < task->subtask_count - 1; i++) {
+        task->subtasks[i] = task->subtasks[i + 1];
+    }
+    task->subtask_count--;
+    notify_task_changed(task_list, index);
+    return TASK_OK;
+}
+
+TaskStatus task_toggle_subtask(Task task_list[], int total_tasks, int index, int subtask) {
+    if (index < 0 || index >= total_tasks) return TASK_NO_SUCH_TASK;
+    Task *task = &task_list[index];
+    if (subtask < 0 || subtask >= task->subtask_count) return TASK_NO_SUCH_SUBTASK;
+
+    task->subtasks[subtask].is_completed = !task->subtasks[subtask].is_completed;
+    notify_task_changed(task_list, index);
+    return TASK_OK;
+}
+
+void sort_tasks(Task task_list[], int total_tasks) {
+    double started = perf_now();
+    for (int i = 0; i < total_tasks - 1; i++) {
+        for (int j = i + 1; j < total_tasks; j++) {
+            if (task_list[i].priority > task_list[j].priority) {
+                Task temp = task_list[i];
+                task_list[i] = task_list[j];
+                task_list[j] = temp;
+            }
+        }
+    }
+    notify_tasks_reloaded(task_list, total_tasks);
+    perf_record(PERF_SORT, started);
+}
+
+// FNV-1a over every saved field, so two records hash alike exactly when
+// they would be written out alike.  Never 0, which marks unsaved tasks.
+static unsigned int hash_bytes(unsigned int hash, const void *data, size_t size) {
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static unsigned int hash_text(unsigned int hash, const char *text) {
+    return hash_bytes(hash, text, strlen(text) + 1);
+}
+
+unsigned int task_hash(const Task *task) {
+    unsigned int hash = 2166136261u;
+    int numbers[4] = { task->is_completed, task->priority, task->category_count, task->subtask_count };
+    hash = hash_text(hash, task->name);
+    hash = hash_bytes(hash, numbers, sizeof(numbers));
+    hash = hash_text(hash, task->deadline);
+    hash = hash_text(hash, task->description);
+    for (int i = 0; i < task->category_count; i++) {
+        hash = hash_text(hash, task->categories[i]);
+    }
+    for (int i = 0; i < task->subtask_count; i++) {
+        hash = hash_text(hash, task->subtasks[i].name);
+        hash = hash_bytes(hash, &task->subtasks[i].is_completed, sizeof(bool));
+    }
+    return hash ? hash : 1;
+}
+
+// Hashes of the records in the file as of the last load, save or merge:
+// the common base that tells local edits apart from edits made on disk.
+static unsigned int synced[MAX_TASKS];
+static int synced_count = 0;
+
+static void mark_synced(Task task_list[], int total_tasks) {
+    for (int i = 0; i < total_tasks; i++) {
+        task_list[i].origin = task_hash(&task_list[i]);
+        synced[i] = task_list[i].origin;
+    }
+    synced_count = total_tasks;
+}
+
+static bool was_synced(unsigned int hash) {
+    for (int i = 0; i < synced_count; i++) {
+        if (synced[i] == hash) return true;
+    }
+    return false;
+}
+
+// Whether the list differs from the file as last synced.
+static bool has_unsaved_changes(Task task_list[], int total_tasks) {
+    if (total_tasks != synced_count) return true;
+    for (int i = 0; i < total_tasks; i++) {
+        if (task_list[i].origin != synced[i] || task_hash(&task_list[i]) != synced[i]) return true;
+    }
+    return false;
+}
+
+// The list is written to a temporary file that is then renamed over
+// filename, so readers see either the old file or the new one, never a
+// partly written one.
+TaskStatus tasks_save(Task task_list[], int total_tasks, const char *filename) {
+    double started = perf_now();
+    char temporary[PATH_MAX];
+    snprintf(temporary, sizeof(temporary), "%s.%ld.tmp", filename, (long)getpid());
+    FILE *file = fopen(temporary, "w");
+    if (file == NULL) return TASK_FILE_ERROR;
+
+    for (int i = 0; i < total_tasks; i++) {
+        fprintf(file, "%s\n", task_list[i].name);
+        fprintf(file, "%d\n", task_list[i].is_completed);
+        fprintf(file, "%d\n", task_list[i].priority);
+        fprintf(file, "%s\n", task_list[i].deadline);
+        fprintf(file, "%s\n", task_list[i].description);
+        fprintf(file, "%d\n", task_list[i].category_count);
+        for (int j = 0; j < task_list[i].category_count; j++) {
+            fprintf(file, "%s\n", task_list[i].categories[j]);
+        }
+        fprintf(file, "%d\n", task_list[i].subtask_count);
+        for (int j = 0; j < task_list[i].subtask_count; j++) {
+            fprintf(file, "%s\n", task_list[i].subtasks[j].name);
+            fprintf(file, "%d\n", task_list[i].subtasks[j].is_completed);
+        }
+    }
+
+    if (fclose(file) != 0 || rename(temporary, filename) != 0) {
+        remove(temporary);
+        return TASK_FILE_ERROR;
+    }
+    perf_record(PERF_SAVE, started);
+    return TASK_OK;
+}
+
+// Saves to a file other instances may be saving to as well.  Under an
+// exclusive lock on filename.lock, what they saved since our last sync is
+// merged in first (see tasks_merge), so each instance adds its own changes
+// to the others' instead of overwriting them.  Nothing is written when the
+// merged list is what the file already holds.  selected_task_index may be
+// NULL.
+TaskStatus tasks_sync(Task task_list[], int *total_tasks, const char *filename, int *selected_task_index) {
+    char lock_path[PATH_MAX];
+    snprintf(lock_path, sizeof(lock_path), "%s.lock", filename);
+    int lock = open(lock_path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (lock < 0) return TASK_FILE_ERROR;
+    while (flock(lock, LOCK_EX) < 0) {
+        if (errno != EINTR) {
+            close(lock);
+            return TASK_FILE_ERROR;
+        }
+    }
+
+    // A missing file is simply written; a merge that does not fit leaves
+    // both the list and the file as they are.
+    MergeResult result;
+    TaskStatus status = tasks_merge(task_list, total_tasks, filename, selected_task_index, &result);
+    if (status == TASK_FILE_ERROR) status = TASK_OK;
+    if (status == TASK_OK && has_unsaved_changes(task_list, *total_tasks)) {
+        status = tasks_save(task_list, *total_tasks, filename);
+        if (status == TASK_OK) mark_synced(task_list, *total_tasks);
+    }
+
+    close(lock);
+    return status;
+}
+
+// The file holds one field per line, so names and descriptions may contain
+// spaces or be empty.
+static bool read_field(FILE *file, char *out, int size) {
+    char line[256];
+    if (!fgets(line, sizeof(line), file)) return false;
+    line[strcspn(line, "\r\n")] = '\0';
+    snprintf(out, size, "%s", line);
+    return true;
+}
+
+static int read_number(FILE *file) {
+    char line[16] = "";
+    read_field(file, line, sizeof(line));
+    return atoi(line);
+}
+
+static void read_tasks(FILE *file, Task task_list[], int *total_tasks) {
+    char name[50];
+    *total_tasks = 0;
+    while (*total_tasks < MAX_TASKS && read_field(file, name, sizeof(name))) {
+        Task *task = &task_list[*total_tasks];
+        memset(task, 0, sizeof(Task));
+        memcpy(task->name, name, sizeof(name));
+        task->is_completed = read_number(file) != 0;
+        task->priority = read_number(file);
+        read_field(file, task->deadline, sizeof(task->deadline));
+        read_field(file, task->description, sizeof(task->description));
+
+        // Entries beyond what a Task holds are read and dropped.
+        char skipped[50];
+        int count = read_number(file);
+        for (int j = 0; j < count; j++) {
+            if (task->category_count < MAX_CATEGORIES) {
+                read_field(file, task->categories[task->category_count++], sizeof(task->categories[0]));
+            } else {
+                read_field(file, skipped, sizeof(skipped));
+            }
+        }
+        count = read_number(file);
+        for (int j = 0; j < count; j++) {
+            if (task->subtask_count < MAX_SUBTASKS) {
+                Subtask *subtask = &task->subtasks[task->subtask_count++];
+                read_field(file, subtask->name, sizeof(subtask->name));
+                subtask->is_completed = read_number(file) != 0;
+            } else {
+                read_field(file, skipped, sizeof(skipped));
+                read_number(file);
+            }
+        }
+        (*total_tasks)++;
+    }
+}
+
+TaskStatus tasks_load(Task task_list[], int *total_tasks, const char *filename) {
+    double started = perf_now();
+    FILE *file = fopen(filename, "r");
+    if (file == NULL) return TASK_FILE_ERROR;
+
+    read_tasks(file, task_list, total_tasks);
+    fclose(file);
+    mark_synced(task_list, *total_tasks);
+    notify_tasks_reloaded(task_list, *total_tasks);
+    perf_record(PERF_LOAD, started);
+    return TASK_OK;
+}
+
+// Folds the changes made to the file since it was last synced into the
+// list, keeping the tasks edited or added here: a task both sides changed
+// is kept in both versions.  The merged list follows the file's order,
+// with the local-only tasks after it.  Tasks keep their place and the
+// indexes are updated per task when the file only replaced or appended
+// records; anything else rebuilds them.  Marks and the selection, if
+// given, follow their tasks.  When the merged list would not fit in
+// MAX_TASKS nothing is changed, the file included, and TASK_LIST_FULL is
+// returned.
+TaskStatus tasks_merge(Task task_list[], int *total_tasks, const char *filename, int *selected_task_index, MergeResult *result) {
+    static Task remote[MAX_TASKS];
+    static Task merged[MAX_TASKS];
+    int remote_count;
+    result->changed = false;
+    result->updated = 0;
+    result->removed = 0;
+
+    double started = perf_now();
+    FILE *file = fopen(filename, "r");
+    if (file == NULL) return TASK_FILE_ERROR;
+    read_tasks(file, remote, &remote_count);
+    fclose(file);
+
+    bool unchanged = remote_count == synced_count;
+    for (int i = 0; i < remote_count; i++) {
+        remote[i].origin = task_hash(&remote[i]);
+        unchanged = unchanged && remote[i].origin == synced[i];
+    }
+    if (unchanged) return TASK_OK;
+
+    // Index in task_list each merged task came from, -1 if from the file.
+    int source[MAX_TASKS];
+    bool claimed[MAX_TASKS] = { false };
+    int count = 0;
+    for (int r = 0; r < remote_count; r++) {
+        int local = -1;
+        for (int l = 0; l < *total_tasks && local < 0; l++) {
+            if (!claimed[l] && task_list[l].origin == remote[r].origin) local = l;
+        }
+        if (local >= 0) {
+            claimed[local] = true;
+            merged[count] = task_list[local];
+            source[count++] = local;
+        } else if (!was_synced(remote[r].origin)) {
+            merged[count] = remote[r];
+            source[count++] = -1;
+            result->updated++;
+        }
+        // Otherwise the record is unchanged on disk and was deleted here.
+    }
+    for (int l = 0; l < *total_tasks; l++) {
+        if (claimed[l]) continue;
+        if (task_list[l].origin == 0 || task_hash(&task_list[l]) != task_list[l].origin) {
+            // Dropping a task edited here would lose it without a trace.
+            if (count == MAX_TASKS) return TASK_LIST_FULL;
+            merged[count] = task_list[l];
+            source[count++] = l;
+        } else {
+            // Unedited here, and deleted or replaced on disk.
+            result->removed++;
+        }
+    }
+    result->changed = true;
+    for (int i = 0; i < remote_count; i++) {
+        synced[i] = remote[i].origin;
+    }
+    synced_count = remote_count;
+
+    bool in_place = count >= *total_tasks;
+    for (int i = 0; i < count && in_place; i++) {
+        in_place = source[i] == i || (source[i] == -1 && (i >= *total_tasks || !claimed[i]));
+    }
+    int old_total = *total_tasks;
+    if (in_place) {
+        for (int i = 0; i < count; i++) {
+            if (source[i] == i) continue;
+            task_list[i] = merged[i];
+            if (i < old_total) {
+                notify_task_changed(task_list, i);
+            } else {
+                *total_tasks = i + 1;
+                notify_task_added(task_list, i);
+            }
+        }
+    } else {
+        memcpy(task_list, merged, count * sizeof(Task));
+        *total_tasks = count;
+    }
+    notify_tasks_merged(task_list, count, source, !in_place);
+
+    if (selected_task_index) {
+        int selected = -1;
+        for (int i = 0; i < count && selected < 0; i++) {
+            if (source[i] == *selected_task_index) selected = i;
+        }
+        if (selected >= 0) {
+            *selected_task_index = selected;
+        } else if (*selected_task_index >= count) {
+            *selected_task_index = count > 0 ? count - 1 : 0;
+        }
+    }
+    perf_record(PERF_LOAD, started);
+    return TASK_OK;
+}
@@ -0,0 +1,85 @@
+#ifndef TASK_CORE_H
+#define TASK_CORE_H
+
+#include <stdbool.h>
+
+// The list is a fixed array of MAX_TASKS, and so are the buffers the
+// merge, the batch mode and the daemon size by it.  The indexes over the
+// list grow with it and do not depend on the cap; raising it only needs
+// the stack and static buffers here to follow.
+#define MAX_TASKS 100
+#define MAX_CATEGORIES 10
+#define MAX_SUBTASKS 50
+
+typedef struct {
+    char name[50];
+    bool is_completed;
+} Subtask;
+
+typedef struct {
+    char name[50];
+    bool is_completed;
+    int priority;
+    char deadline[11];
+    char description[100];
+    char categories[10][30];
+    int category_count;
+    Subtask subtasks[50];
+    int subtask_count;
+    // task_hash() of the record as last read from or written to the file,
+    // 0 for a task added since.  Not saved.
+    unsigned int origin;
+} Task;
+
+// What tasks_merge did: whether the list changed, how many tasks it took
+// from the file and how many unedited local ones it dropped.
+typedef struct {
+    bool changed;
+    int updated;
+    int removed;
+} MergeResult;
+
+typedef enum {
+    TASK_OK,
+    TASK_LIST_FULL,
+    TASK_NO_SUCH_TASK,
+    TASK_NO_SUCH_SUBTASK,
+    TASK_SUBTASKS_FULL,
+    TASK_EMPTY_NAME,
+    TASK_BAD_DEADLINE,
+    TASK_BAD_PRIORITY,
+    TASK_BAD_CATEGORIES,
+    TASK_FILE_ERROR
+} TaskStatus;
+
+// The task operations without any terminal I/O, shared by the curses
+// front end and batch mode.  Each one checks its arguments first and
+// leaves the list untouched unless it returns TASK_OK; every change is
+// announced through task_events.  Task and subtask indexes are 0-based.
+int is_valid_date_format(const char *date);
+int date_to_day_number(const char *date);
+int today_day_number(void);
+int parse_categories(const char *value, char categories[10][30]);
+const char *task_status_message(TaskStatus status);
+
+TaskStatus task_add(Task task_list[], int *total_tasks, const char *name, const char *categories, const char *deadline, const char *description, int priority);
+TaskStatus task_delete(Task task_list[], int *total_tasks, int index);
+TaskStatus task_delete_many(Task task_list[], int *total_tasks, const int indexes[], int count);
+TaskStatus task_set_name(Task task_list[], int total_tasks, int index, const char *name);
+TaskStatus task_set_description(Task task_list[], int total_tasks, int index, const char *description);
+TaskStatus task_set_deadline(Task task_list[], int total_tasks, int index, const char *deadline);
+TaskStatus task_set_categories(Task task_list[], int total_tasks, int index, const char *categories);
+TaskStatus task_add_categories(Task task_list[], int total_tasks, int index, const char *categories);
+TaskStatus task_set_priority(Task task_list[], int total_tasks, int index, int priority);
+TaskStatus task_toggle(Task task_list[], int total_tasks, int index);
+TaskStatus task_add_subtask(Task task_list[], int total_tasks, int index, const char *name);
+TaskStatus task_delete_subtask(Task task_list[], int total_tasks, int index, int subtask);
+TaskStatus task_toggle_subtask(Task task_list[], int total_tasks, int index, int subtask);
+void sort_tasks(Task task_list[], int total_tasks);
+TaskStatus tasks_save(Task task_list[], int total_tasks, const char *filename);
+TaskStatus tasks_load(Task task_list[], int *total_tasks, const char *filename);
+TaskStatus tasks_sync(Task task_list[], int *total_tasks, const char *filename, int *selected_task_index);
+unsigned int task_hash(const Task *task);
+TaskStatus tasks_merge(Task task_list[], int *total_tasks, const char *filename, int *selected_task_index, MergeResult *result);
+
+#endif
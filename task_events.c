@@ -0,0 +1,84 @@
+#include "task_events.h"
+#include "next_up.h"
+#include "search_index.h"
+#include "trigram_index.h"
+#include "text_arena.h"
+#include "search.h"
+#include "task_columns.h"
+#include "task_view.h"
+#include "bitmap_index.h"
+#include "deadline_index.h"
+#include "row_cache.h"
+#include "marks.h"
+#include "task_ids.h"
+
+void notify_task_added(Task task_list[], int index) {
+    next_up_task_changed(task_list, index);
+    text_arena_task_changed(task_list, index);
+    search_index_task_changed(task_list, index);
+    trigram_index_task_changed(task_list, index);
+    task_columns_task_changed(task_list, index);
+    bitmap_index_task_changed(task_list, index);
+    deadline_index_task_changed(task_list, index);
+    row_cache_task_changed(task_list, index);
+    search_invalidate();
+    view_mark_dirty();
+}
+
+void notify_task_changed(Task task_list[], int index) {
+    next_up_task_changed(task_list, index);
+    text_arena_task_changed(task_list, index);
+    search_index_task_changed(task_list, index);
+    trigram_index_task_changed(task_list, index);
+    task_columns_task_changed(task_list, index);
+    bitmap_index_task_changed(task_list, index);
+    deadline_index_task_changed(task_list, index);
+    row_cache_task_changed(task_list, index);
+    search_invalidate();
+    view_mark_dirty();
+}
+
+// Called after the array has already been shifted down over index.
+void notify_task_removed(Task task_list[], int total_tasks, int index) {
+    (void)task_list;
+    (void)total_tasks;
+    next_up_task_removed(index);
+    text_arena_task_removed(index);
+    search_index_task_removed(index);
+    trigram_index_task_removed(index);
+    task_columns_task_removed(index);
+    bitmap_index_task_removed(index);
+    deadline_index_task_removed(index);
+    row_cache_task_removed(index);
+    marks_task_removed(index);
+    task_ids_removed(index);
+    search_invalidate();
+    view_mark_dirty();
+}
+
+static void rebuild_indexes(Task task_list[], int total_tasks) {
+    task_ids_build(total_tasks);
+    next_up_build(task_list, total_tasks);
+    text_arena_build(task_list, total_tasks);
+    search_index_build(task_list, total_tasks);
+    trigram_index_build(task_list, total_tasks);
+    task_columns_build(task_list, total_tasks);
+    bitmap_index_build(task_list, total_tasks);
+    deadline_index_build(task_list, total_tasks);
+    row_cache_build(task_list, total_tasks);
+    search_invalidate();
+    view_mark_dirty();
+}
+
+void notify_tasks_reloaded(Task task_list[], int total_tasks) {
+    rebuild_indexes(task_list, total_tasks);
+    marks_clear();
+}
+
+// Called after tasks_merge: task i came from index source[i] of the list
+// before the merge, or from the file if -1.  Tasks merged in place have
+// already been announced one by one; a reordered list is rebuilt here.
+void notify_tasks_merged(Task task_list[], int total_tasks, const int source[], bool reordered) {
+    marks_remap(source, total_tasks);
+    if (reordered) rebuild_indexes(task_list, total_tasks);
+}
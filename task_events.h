@@ -0,0 +1,15 @@
+#ifndef TASK_EVENTS_H
+#define TASK_EVENTS_H
+
+#include "task_manager.h"
+
+// Every mutation of task_list goes through one of these so the derived
+// structures (next-up heap, search indexes, ...) stay in step with the data.
+// The text arena is refreshed before the indexes that tokenize its text.
+void notify_task_added(Task task_list[], int index);
+void notify_task_changed(Task task_list[], int index);
+void notify_task_removed(Task task_list[], int total_tasks, int index);
+void notify_tasks_reloaded(Task task_list[], int total_tasks);
+void notify_tasks_merged(Task task_list[], int total_tasks, const int source[], bool reordered);
+
+#endif
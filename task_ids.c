@@ -0,0 +1,81 @@
+#include "task_ids.h"
+#include <stdlib.h>
+#include <string.h>
+
+// The id of the task at each index, ascending.
+static int *ids = NULL;
+static int id_count = 0;
+static int id_capacity = 0;
+static int next_id = 0;
+
+void task_ids_build(int total_tasks) {
+    id_count = 0;
+    next_id = 0;
+    if (total_tasks > 0) task_id_at(total_tasks - 1);
+}
+
+void task_ids_removed(int index) {
+    if (index >= id_count) return;
+    memmove(&ids[index], &ids[index + 1], (id_count - index - 1) * sizeof(int));
+    id_count--;
+}
+
+int task_id_at(int index) {
+    if (index >= id_capacity) {
+        id_capacity = id_capacity ? id_capacity : 128;
+        while (id_capacity <= index) id_capacity *= 2;
+        ids = realloc(ids, id_capacity * sizeof(int));
+    }
+    while (id_count <= index) {
+        ids[id_count++] = next_id++;
+    }
+    return ids[index];
+}
+
+int task_index_of(int id) {
+    int low = 0, high = id_count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (ids[mid] < id) low = mid + 1;
+        else high = mid;
+    }
+    return low < id_count && ids[low] == id ? low : -1;
+}
+
+TermList *term_lists_at(TermLists *lists, int index) {
+    if (index >= lists->count) {
+        if (index >= lists->capacity) {
+            lists->capacity = lists->capacity ? lists->capacity : 128;
+            while (lists->capacity <= index) lists->capacity *= 2;
+            lists->lists = realloc(lists->lists, lists->capacity * sizeof(TermList));
+        }
+        memset(&lists->lists[lists->count], 0, (index + 1 - lists->count) * sizeof(TermList));
+        lists->count = index + 1;
+    }
+    return &lists->lists[index];
+}
+
+void term_lists_reset(TermLists *lists, int total_tasks) {
+    for (int i = total_tasks; i < lists->count; i++) {
+        free(lists->lists[i].ids);
+    }
+    if (lists->count > total_tasks) lists->count = total_tasks;
+    for (int i = 0; i < lists->count; i++) {
+        lists->lists[i].count = 0;
+    }
+}
+
+void term_lists_removed(TermLists *lists, int index) {
+    if (index >= lists->count) return;
+    free(lists->lists[index].ids);
+    memmove(&lists->lists[index], &lists->lists[index + 1], (lists->count - index - 1) * sizeof(TermList));
+    lists->count--;
+}
+
+void term_list_push(TermList *list, int id) {
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 8;
+        list->ids = realloc(list->ids, list->capacity * sizeof(int));
+    }
+    list->ids[list->count++] = id;
+}
@@ -0,0 +1,40 @@
+#ifndef TASK_IDS_H
+#define TASK_IDS_H
+
+// Stable ids for the tasks in the list, for indexes that would otherwise
+// have to renumber everything behind a deleted task.  Ids are handed out
+// in list order and tasks are only added at the end of the list (sorts
+// and reloads rebuild), so the ids stay sorted by index and an id maps
+// back to its index with a binary search.
+//
+// task_events keeps this in step: task_ids_build before the indexes are
+// rebuilt, task_ids_removed after every index has dropped the task, so
+// they can still look up its id.  task_id_at hands out ids to new tasks.
+void task_ids_build(int total_tasks);
+void task_ids_removed(int index);
+int task_id_at(int index);
+// The index of the task with id, or -1 if it has been removed.
+int task_index_of(int id);
+
+// What the search indexes keep per task to find its postings again: the
+// ids of the terms (tokens, trigrams) it is filed under, by task index.
+typedef struct {
+    int *ids;
+    int count;
+    int capacity;
+} TermList;
+
+typedef struct {
+    TermList *lists;
+    int count;
+    int capacity;
+} TermLists;
+
+// The list of the task at index, growing the table with empty lists.
+TermList *term_lists_at(TermLists *lists, int index);
+// Empties every list, for total_tasks tasks.
+void term_lists_reset(TermLists *lists, int total_tasks);
+void term_lists_removed(TermLists *lists, int index);
+void term_list_push(TermList *list, int id);
+
+#endif
@@ -1,392 +1,361 @@
 #include "task_manager.h"
+#include "task_view.h"
+#include "bitmap_index.h"
+#include "render.h"
+#include "row_cache.h"
+#include "form.h"
+#include "marks.h"
 #include <ncurses.h>
 #include <string.h>
 #include <stdlib.h>
-#include <ctype.h>
 #include <cjson/cJSON.h>
 
-int is_valid_date_format(const char *date) {
-    if (strlen(date) != 10) return 0;
+// Where the open form's values go when it is submitted.
+static Task *form_tasks;
+static int *form_total_tasks;
+static int form_task;
 
-    if (!isdigit(date[0]) || !isdigit(date[1]) || date[2] != '/' ||
-        !isdigit(date[3]) || !isdigit(date[4]) || date[5] != '/' ||
-        !isdigit(date[6]) || !isdigit(date[7]) ||
-        !isdigit(date[8]) || !isdigit(date[9])) {
-        return 0;
+static bool validate_name(const char *value, char *error, int error_size) {
+    for (; *value; value++) {
+        if (*value != ' ') return true;
     }
+    snprintf(error, error_size, "%s", task_status_message(TASK_EMPTY_NAME));
+    return false;
+}
 
-    int day = (date[0] - '0') * 10 + (date[1] - '0');
-    int month = (date[3] - '0') * 10 + (date[4] - '0');
-    int year = (date[6] - '0') * 1000 + (date[7] - '0') * 100 +
-               (date[8] - '0') * 10 + (date[9] - '0');
+static bool validate_deadline(const char *value, char *error, int error_size) {
+    if (is_valid_date_format(value)) return true;
+    snprintf(error, error_size, "%s", task_status_message(TASK_BAD_DEADLINE));
+    return false;
+}
 
-    if (day < 1 || day > 31 || month < 1 || month > 12 || year < 1) {
-        return 0;
-    }
+static bool validate_priority(const char *value, char *error, int error_size) {
+    if (value[0] >= '1' && value[0] <= '9' && value[1] == '\0') return true;
+    snprintf(error, error_size, "%s", task_status_message(TASK_BAD_PRIORITY));
+    return false;
+}
 
-    return 1;
+static bool validate_categories(const char *value, char *error, int error_size) {
+    char categories[10][30];
+    if (parse_categories(value, categories) >= 0) return true;
+    snprintf(error, error_size, "%s", task_status_message(TASK_BAD_CATEGORIES));
+    return false;
 }
 
-void add_new_task(Task task_list[], int *total_tasks) {
-    if (*total_tasks >= 100) {
-        mvprintw(27, 0, "Task limit reached. Cannot add more tasks.");
-        refresh();
-        return;
+static void join_categories(Task *task, char *out, int size) {
+    out[0] = '\0';
+    int used = 0;
+    for (int i = 0; i < task->category_count && used < size; i++) {
+        used += snprintf(out + used, size - used, i ? ", %s" : "%s", task->categories[i]);
     }
+}
 
-    char task_name[50];
-    char category[30];
-    char deadline[11];
-    char description[100];
-    int category_count;
-    int priority;
-
-    echo();
-    curs_set(1);
-
-    mvprintw(27, 0, "Enter task name: ");
-    getnstr(task_name, 49);
-
-    mvprintw(28, 0, "Enter number of categories (max 10): ");
-    scanw("%d", &category_count);
+// Reports how an operation went on the status line.
+static void report(TaskStatus status, const char *success) {
+    mvprintw(status_row, 0, "%s", status == TASK_OK ? success : task_status_message(status));
+}
 
-    Task *new_task = &task_list[(*total_tasks)++];
-    new_task->category_count = category_count > 10 ? 10 : category_count;
+static void submit_new_task(char values[][FORM_VALUE_SIZE]) {
+    report(task_add(form_tasks, form_total_tasks, values[0], values[1], values[2], values[3], atoi(values[4])),
+           "Task added successfully!");
+}
 
-    for (int i = 0; i < new_task->category_count; i++) {
-        mvprintw(29 + i, 0, "Enter category %d: ", i + 1);
-        getnstr(category, 29);
-        strncpy(new_task->categories[i], category, 29);
+void add_new_task(Task task_list[], int *total_tasks) {
+    if (*total_tasks >= MAX_TASKS) {
+        mvprintw(status_row, 0, "Task limit reached. Cannot add more tasks.");
+        return;
     }
 
-    do {
-        mvprintw(29 + category_count, 0, "Enter deadline (DD/MM/YYYY): ");
-        getnstr(deadline, 10);
-        if (!is_valid_date_format(deadline)) {
-            mvprintw(30 + category_count, 0, "Invalid date format. Try again.   ");
-        }
-    } while (!is_valid_date_format(deadline));
-
-    mvprintw(31 + category_count, 0, "Enter description: ");
-    getnstr(description, 99);
-
-    mvprintw(32 + category_count, 0, "Enter priority (1-9): ");
-    scanw("%d", &priority);
-    if (priority < 1 || priority > 9) priority = 1;
-
-    noecho();
-    curs_set(0);
-
-    strncpy(new_task->name, task_name, 49);
-    strncpy(new_task->deadline, deadline, 10);
-    strncpy(new_task->description, description, 99);
-    new_task->is_completed = false;
-    new_task->priority = priority;
-    new_task->subtask_count = 0;
-
-    mvprintw(27, 0, "Task added successfully!                             ");
-    refresh();
+    form_tasks = task_list;
+    form_total_tasks = total_tasks;
+    form_open("New task", submit_new_task);
+    form_add_field("Name", "", 49, validate_name);
+    form_add_field("Categories, comma separated", "", FORM_VALUE_SIZE - 1, validate_categories);
+    form_add_field("Deadline (DD/MM/YYYY)", "", 10, validate_deadline);
+    form_add_field("Description", "", 99, NULL);
+    form_add_field("Priority (1-9)", "1", 1, validate_priority);
 }
 
 void delete_selected_task(Task task_list[], int *total_tasks, int selected_task_index) {
     if (*total_tasks == 0) {
-        mvprintw(27, 0, "No tasks available to delete.");
-        refresh();
+        mvprintw(status_row, 0, "No tasks available to delete.");
         return;
     }
+    report(task_delete(task_list, total_tasks, selected_task_index), "Task deleted successfully!");
+}
 
-    for (int i = selected_task_index; i < *total_tasks - 1; i++) {
-        task_list[i] = task_list[i + 1];
-    }
-    (*total_tasks)--;
-    if (selected_task_index >= *total_tasks && *total_tasks > 0) {
-        selected_task_index = *total_tasks - 1;
+static void submit_task_name(char values[][FORM_VALUE_SIZE]) {
+    report(task_set_name(form_tasks, *form_total_tasks, form_task, values[0]), "Task name updated successfully!");
+}
+
+void edit_task_name(Task task_list[], int *total_tasks, int selected_task_index) {
+    if (selected_task_index < 0 || selected_task_index >= *total_tasks) {
+        mvprintw(status_row, 0, "No tasks available to edit.");
+        return;
     }
 
-    mvprintw(27, 0, "Task deleted successfully!                           ");
-    refresh();
+    form_tasks = task_list;
+    form_total_tasks = total_tasks;
+    form_task = selected_task_index;
+    form_open("Edit task", submit_task_name);
+    form_add_field("Name", task_list[selected_task_index].name, 49, validate_name);
 }
 
-void edit_task_name(Task task_list[], int selected_task_index) {
-    if (selected_task_index < 0 || selected_task_index >= 100) {
-        mvprintw(27, 0, "No tasks available to edit.");
-        refresh();
+static void submit_task_description(char values[][FORM_VALUE_SIZE]) {
+    report(task_set_description(form_tasks, *form_total_tasks, form_task, values[0]), "Task description updated successfully!");
+}
+
+void edit_task_description(Task task_list[], int *total_tasks, int selected_task_index) {
+    if (selected_task_index < 0 || selected_task_index >= *total_tasks) {
+        mvprintw(status_row, 0, "No tasks available to edit.");
         return;
     }
 
-    echo();
-    curs_set(1);
-    mvprintw(27, 0, "Enter new task name: ");
-    getnstr(task_list[selected_task_index].name, 49);
-    noecho();
-    curs_set(0);
-    mvprintw(27, 0, "Task name updated successfully!");
-    refresh();
+    form_tasks = task_list;
+    form_total_tasks = total_tasks;
+    form_task = selected_task_index;
+    form_open("Edit task", submit_task_description);
+    form_add_field("Description", task_list[selected_task_index].description, 99, NULL);
 }
 
-void edit_task_description(Task task_list[], int selected_task_index) {
-    if (selected_task_index < 0 || selected_task_index >= 100) {
-        mvprintw(27, 0, "No tasks available to edit.");
-        refresh();
+static void submit_deadline(char values[][FORM_VALUE_SIZE]) {
+    report(task_set_deadline(form_tasks, *form_total_tasks, form_task, values[0]), "Deadline updated successfully!");
+}
+
+void add_new_deadline(Task task_list[], int *total_tasks, int selected_task_index) {
+    if (selected_task_index < 0 || selected_task_index >= *total_tasks) {
+        mvprintw(status_row, 0, "No tasks available to edit.");
         return;
     }
 
-    echo();
-    curs_set(1);
-    mvprintw(27, 0, "Enter new description: ");
-    getnstr(task_list[selected_task_index].description, 99);
-    noecho();
-    curs_set(0);
-    mvprintw(27, 0, "Task description updated successfully!");
-    refresh();
+    form_tasks = task_list;
+    form_total_tasks = total_tasks;
+    form_task = selected_task_index;
+    form_open("Edit task", submit_deadline);
+    form_add_field("Deadline (DD/MM/YYYY)", task_list[selected_task_index].deadline, 10, validate_deadline);
 }
 
-void add_new_deadline(Task task_list[], int selected_task_index) {
-    if (selected_task_index < 0 || selected_task_index >= 100) {
-        mvprintw(27, 0, "No tasks available to edit.");
-        refresh();
+static void submit_categories(char values[][FORM_VALUE_SIZE]) {
+    report(task_set_categories(form_tasks, *form_total_tasks, form_task, values[0]), "Categories updated successfully!");
+}
+
+void manage_categories(Task task_list[], int *total_tasks, int selected_task_index) {
+    if (selected_task_index < 0 || selected_task_index >= *total_tasks) {
+        mvprintw(status_row, 0, "No tasks available to edit.");
         return;
     }
 
-    char new_deadline[11];
-    echo();
-    curs_set(1);
-    do {
-        mvprintw(27, 0, "Enter new deadline (DD/MM/YYYY): ");
-        getnstr(new_deadline, 10);
-        if (!is_valid_date_format(new_deadline)) {
-            mvprintw(28, 0, "Invalid date format. Try again.");
-        }
-    } while (!is_valid_date_format(new_deadline));
-
-    strncpy(task_list[selected_task_index].deadline, new_deadline, 10);
-    noecho();
-    curs_set(0);
-    mvprintw(27, 0, "Deadline updated successfully!");
-    refresh();
+    char current[FORM_VALUE_SIZE];
+    join_categories(&task_list[selected_task_index], current, sizeof(current));
+    form_tasks = task_list;
+    form_total_tasks = total_tasks;
+    form_task = selected_task_index;
+    form_open("Edit task", submit_categories);
+    form_add_field("Categories, comma separated", current, FORM_VALUE_SIZE - 1, validate_categories);
 }
 
-void manage_categories(Task task_list[], int selected_task_index) {
-    static bool category_mode = false;
-    if (!category_mode) {
-        category_mode = true;
-        mvprintw(27, 0, "Category mode enabled. Use 'a' to add, 'd' to delete, 'j/k' to navigate. Press 'c' to exit.");
+// Other instances' saves since ours are merged in first; see tasks_sync.
+void save_tasks_to_file(Task task_list[], int *total_tasks, const char *filename, int *selected_task_index) {
+    TaskStatus status = tasks_sync(task_list, total_tasks, filename, selected_task_index);
+    if (status == TASK_LIST_FULL) {
+        mvprintw(status_row, 0, "Not saved: with the changes saved elsewhere there would be over %d tasks.", MAX_TASKS);
+    } else if (status != TASK_OK) {
+        mvprintw(status_row, 0, "Error opening file for writing.");
     } else {
-        category_mode = false;
-        mvprintw(27, 0, "Category mode disabled. Returning to task view.");
+        mvprintw(status_row, 0, "Tasks saved successfully!");
     }
     refresh();
+}
 
-    while (category_mode) {
-        int ch = getch();
-        switch (ch) {
-            case 'a':
-                if (task_list[selected_task_index].category_count >= 10) {
-                    mvprintw(27, 0, "Category limit reached for this task.");
-                } else {
-                    echo();
-                    curs_set(1);
-                    mvprintw(28, 0, "Enter new category: ");
-                    getnstr(task_list[selected_task_index].categories[task_list[selected_task_index].category_count++], 29);
-                    noecho();
-                    curs_set(0);
-                    mvprintw(27, 0, "Category added successfully!");
-                }
-                break;
-
-            case 'd':
-                if (task_list[selected_task_index].category_count == 0) {
-                    mvprintw(27, 0, "No categories to delete.");
-                } else {
-                    for (int i = selected_task_index; i < task_list[selected_task_index].category_count - 1; i++) {
-                        strncpy(task_list[selected_task_index].categories[i], task_list[selected_task_index].categories[i + 1], 30);
-                    }
-                    task_list[selected_task_index].category_count--;
-                    if (selected_task_index >= task_list[selected_task_index].category_count && task_list[selected_task_index].category_count > 0) {
-                        selected_task_index = task_list[selected_task_index].category_count - 1;
-                    }
-                    mvprintw(27, 0, "Category deleted successfully!");
-                }
-                break;
-
-            case 'j':
-                if (selected_task_index < task_list[selected_task_index].category_count - 1) {
-                    selected_task_index++;
-                }
-                break;
-
-            case 'k':
-                if (selected_task_index > 0) {
-                    selected_task_index--;
-                }
-                break;
-
-            case 'c':
-                category_mode = false;
-                mvprintw(27, 0, "Exiting category mode...");
-                break;
-        }
-
-        display_metadata(task_list, selected_task_index);
+void load_tasks_from_file(Task task_list[], int *total_tasks, const char *filename) {
+    if (tasks_load(task_list, total_tasks, filename) != TASK_OK) {
+        mvprintw(status_row, 0, "Error opening file for reading.");
+    } else {
+        mvprintw(status_row, 0, "Tasks loaded successfully!");
     }
+    refresh();
 }
 
-void sort_tasks(Task task_list[], int total_tasks) {
-    for (int i = 0; i < total_tasks - 1; i++) {
-        for (int j = i + 1; j < total_tasks; j++) {
-            if (task_list[i].priority > task_list[j].priority) {
-                Task temp = task_list[i];
-                task_list[i] = task_list[j];
-                task_list[j] = temp;
-            }
-        }
-    }
+static void submit_subtask(char values[][FORM_VALUE_SIZE]) {
+    report(task_add_subtask(form_tasks, *form_total_tasks, form_task, values[0]), "Subtask added successfully!");
 }
 
-void search_tasks(Task task_list[], int total_tasks, const char *query, int *selected_task_index) {
-    for (int i = 0; i < total_tasks; i++) {
-        if (strstr(task_list[i].name, query) != NULL) {
-            *selected_task_index = i;
-            break;
-        }
+void add_new_subtask(Task task_list[], int *total_tasks, int selected_task_index) {
+    if (selected_task_index >= *total_tasks) {
+        mvprintw(status_row, 0, "No tasks available to edit.");
+        return;
     }
+    if (task_list[selected_task_index].subtask_count >= MAX_SUBTASKS) {
+        mvprintw(status_row, 0, "Subtask limit reached. Cannot add more subtasks.");
+        return;
+    }
+
+    form_tasks = task_list;
+    form_total_tasks = total_tasks;
+    form_task = selected_task_index;
+    form_open("New subtask", submit_subtask);
+    form_add_field("Name", "", 49, validate_name);
 }
 
-void save_tasks_to_file(Task task_list[], int total_tasks, const char *filename) {
-    FILE *file = fopen(filename, "w");
-    if (file == NULL) {
-        mvprintw(27, 0, "Error opening file for writing.");
-        refresh();
+void delete_selected_subtask(Task task_list[], int total_tasks, int selected_task_index, int selected_subtask_index) {
+    if (task_list[selected_task_index].subtask_count == 0) {
+        mvprintw(status_row, 0, "No subtasks available to delete.");
         return;
     }
+    report(task_delete_subtask(task_list, total_tasks, selected_task_index, selected_subtask_index), "Subtask deleted successfully!");
+}
 
-    for (int i = 0; i < total_tasks; i++) {
-        fprintf(file, "%s\n", task_list[i].name);
-        fprintf(file, "%d\n", task_list[i].is_completed);
-        fprintf(file, "%d\n", task_list[i].priority);
-        fprintf(file, "%s\n", task_list[i].deadline);
-        fprintf(file, "%s\n", task_list[i].description);
-        fprintf(file, "%d\n", task_list[i].category_count);
-        for (int j = 0; j < task_list[i].category_count; j++) {
-            fprintf(file, "%s\n", task_list[i].categories[j]);
-        }
-        fprintf(file, "%d\n", task_list[i].subtask_count);
-        for (int j = 0; j < task_list[i].subtask_count; j++) {
-            fprintf(file, "%s\n", task_list[i].subtasks[j].name);
-            fprintf(file, "%d\n", task_list[i].subtasks[j].is_completed);
-        }
+// Runs op over every marked task in one pass and reports the outcome once.
+typedef TaskStatus (*MarkedOperation)(Task task_list[], int total_tasks, int index, const char *value);
+
+static void apply_to_marked(Task task_list[], int total_tasks, MarkedOperation op, const char *value, const char *done) {
+    const int *tasks;
+    int count = marks_collect(&tasks);
+    int failed = 0;
+    TaskStatus first_error = TASK_OK;
+    for (int i = 0; i < count; i++) {
+        TaskStatus status = op(task_list, total_tasks, tasks[i], value);
+        if (status != TASK_OK && failed++ == 0) first_error = status;
+    }
+    if (failed) {
+        mvprintw(status_row, 0, "%s %d of %d marked tasks; %d failed: %s", done, count - failed, count, failed, task_status_message(first_error));
+    } else {
+        mvprintw(status_row, 0, "%s %d marked task(s).", done, count);
     }
+}
 
-    fclose(file);
-    mvprintw(27, 0, "Tasks saved successfully!                             ");
-    refresh();
+static TaskStatus toggle_one(Task task_list[], int total_tasks, int index, const char *value) {
+    (void)value;
+    return task_toggle(task_list, total_tasks, index);
 }
 
-void load_tasks_from_file(Task task_list[], int *total_tasks, const char *filename) {
-    FILE *file = fopen(filename, "r");
-    if (file == NULL) {
-        mvprintw(27, 0, "Error opening file for reading.");
-        refresh();
-        return;
+static TaskStatus set_priority_one(Task task_list[], int total_tasks, int index, const char *value) {
+    return task_set_priority(task_list, total_tasks, index, atoi(value));
+}
+
+static void submit_priority(char values[][FORM_VALUE_SIZE]) {
+    if (marks_count() > 0) {
+        apply_to_marked(form_tasks, *form_total_tasks, set_priority_one, values[0], "Priority set on");
+    } else {
+        report(task_set_priority(form_tasks, *form_total_tasks, form_task, atoi(values[0])), "Priority updated successfully!");
     }
+}
 
-    *total_tasks = 0;
-    while (fscanf(file, "%s\n", task_list[*total_tasks].name) != EOF) {
-        fscanf(file, "%d\n", &task_list[*total_tasks].is_completed);
-        fscanf(file, "%d\n", &task_list[*total_tasks].priority);
-        fscanf(file, "%s\n", task_list[*total_tasks].deadline);
-        fscanf(file, "%s\n", task_list[*total_tasks].description);
-        fscanf(file, "%d\n", &task_list[*total_tasks].category_count);
-        for (int j = 0; j < task_list[*total_tasks].category_count; j++) {
-            fscanf(file, "%s\n", task_list[*total_tasks].categories[j]);
-        }
-        fscanf(file, "%d\n", &task_list[*total_tasks].subtask_count);
-        for (int j = 0; j < task_list[*total_tasks].subtask_count; j++) {
-            fscanf(file, "%s\n", task_list[*total_tasks].subtasks[j].name);
-            fscanf(file, "%d\n", &task_list[*total_tasks].subtasks[j].is_completed);
+// Sets the priority of the marked tasks, or of the selected one if none
+// are marked.
+void edit_priority(Task task_list[], int *total_tasks, int selected_task_index) {
+    char current[2] = "1";
+    if (marks_count() == 0) {
+        if (selected_task_index < 0 || selected_task_index >= *total_tasks) {
+            mvprintw(status_row, 0, "No tasks available to edit.");
+            return;
         }
-        (*total_tasks)++;
+        current[0] = '0' + task_list[selected_task_index].priority;
     }
 
-    fclose(file);
-    mvprintw(27, 0, "Tasks loaded successfully!                             ");
-    refresh();
+    form_tasks = task_list;
+    form_total_tasks = total_tasks;
+    form_task = selected_task_index;
+    form_open(marks_count() > 0 ? "Marked tasks" : "Edit task", submit_priority);
+    form_add_field("Priority (1-9)", current, 1, validate_priority);
 }
 
-void add_new_subtask(Task task_list[], int selected_task_index) {
-    if (task_list[selected_task_index].subtask_count >= 50) {
-        mvprintw(27, 0, "Subtask limit reached. Cannot add more subtasks.");
-        refresh();
-        return;
-    }
-
-    char subtask_name[50];
-    echo();
-    curs_set(1);
-    mvprintw(27, 0, "Enter subtask name: ");
-    getnstr(subtask_name, 49);
-    noecho();
-    curs_set(0);
+void delete_marked_tasks(Task task_list[], int *total_tasks) {
+    const int *tasks;
+    int count = marks_collect(&tasks);
+    report(task_delete_many(task_list, total_tasks, tasks, count), "Marked tasks deleted.");
+}
 
-    Subtask *new_subtask = &task_list[selected_task_index].subtasks[task_list[selected_task_index].subtask_count++];
-    strncpy(new_subtask->name, subtask_name, 49);
-    new_subtask->is_completed = false;
+void toggle_marked_tasks(Task task_list[], int total_tasks) {
+    apply_to_marked(task_list, total_tasks, toggle_one, NULL, "Toggled");
+}
 
-    mvprintw(27, 0, "Subtask added successfully!                             ");
-    refresh();
+static void submit_marked_deadline(char values[][FORM_VALUE_SIZE]) {
+    apply_to_marked(form_tasks, *form_total_tasks, task_set_deadline, values[0], "Deadline set on");
 }
 
-void delete_selected_subtask(Task task_list[], int selected_task_index) {
-    if (task_list[selected_task_index].subtask_count == 0) {
-        mvprintw(27, 0, "No subtasks available to delete.");
-        refresh();
-        return;
-    }
+void set_marked_deadline(Task task_list[], int *total_tasks) {
+    form_tasks = task_list;
+    form_total_tasks = total_tasks;
+    form_open("Marked tasks", submit_marked_deadline);
+    form_add_field("Deadline (DD/MM/YYYY)", "", 10, validate_deadline);
+}
 
-    for (int i = selected_task_index; i < task_list[selected_task_index].subtask_count - 1; i++) {
-        task_list[selected_task_index].subtasks[i] = task_list[selected_task_index].subtasks[i + 1];
-    }
-    task_list[selected_task_index].subtask_count--;
-    if (selected_task_index >= task_list[selected_task_index].subtask_count && task_list[selected_task_index].subtask_count > 0) {
-        selected_task_index = task_list[selected_task_index].subtask_count - 1;
-    }
+static void submit_marked_categories(char values[][FORM_VALUE_SIZE]) {
+    apply_to_marked(form_tasks, *form_total_tasks, task_add_categories, values[0], "Categories added to");
+}
 
-    mvprintw(27, 0, "Subtask deleted successfully!                           ");
-    refresh();
+void add_marked_categories(Task task_list[], int *total_tasks) {
+    form_tasks = task_list;
+    form_total_tasks = total_tasks;
+    form_open("Marked tasks", submit_marked_categories);
+    form_add_field("Categories to add, comma separated", "", FORM_VALUE_SIZE - 1, validate_categories);
 }
 
-void toggle_subtask_status(Task task_list[], int selected_task_index, int selected_subtask_index) {
-    if (selected_task_index >= 0 && selected_task_index < 100 && selected_subtask_index >= 0 && selected_subtask_index < task_list[selected_task_index].subtask_count) {
-        task_list[selected_task_index].subtasks[selected_subtask_index].is_completed = !task_list[selected_task_index].subtasks[selected_subtask_index].is_completed;
+static Viewport task_viewport = { 0 };
+static Viewport subtask_viewport = { 0 };
+
+void display_subtasks(Task task_list[], int selected_task_index, int selected_subtask_index) {
+    Task *task = &task_list[selected_task_index];
+    int height = render_pane_height(PANE_SUBTASKS);
+    viewport_follow(&subtask_viewport, selected_subtask_index, task->subtask_count, height);
+
+    render_begin(PANE_SUBTASKS);
+    for (int row = 0; row < height && subtask_viewport.offset + row < task->subtask_count; row++) {
+        int i = subtask_viewport.offset + row;
+        render_line(PANE_SUBTASKS, row, i == selected_subtask_index ? A_REVERSE : A_NORMAL,
+                    "%d. [%c] %s", i + 1, task->subtasks[i].is_completed ? 'x' : ' ', task->subtasks[i].name);
     }
 }
 
-void display_subtasks(Task task_list[], int selected_task_index) {
-    clear();
-    for (int i = 0; i < task_list[selected_task_index].subtask_count; i++) {
-        mvprintw(i, 0, "%d. [%c] %s", i + 1, task_list[selected_task_index].subtasks[i].is_completed ? 'x' : ' ', task_list[selected_task_index].subtasks[i].name);
-    }
-    refresh();
+// Marked tasks are drawn bold, the selected one reversed.
+static int row_attributes(int task, int selected_task_index) {
+    return (task == selected_task_index ? A_REVERSE : A_NORMAL) | (marks_is_marked(task) ? A_BOLD : A_NORMAL);
 }
 
+// Only the rows inside the task pane are drawn, so a frame costs the same
+// for ten tasks as for ten thousand; each row comes formatted from the
+// row cache.
 void display_tasks(Task task_list[], int total_tasks, int selected_task_index, bool is_in_subtask_mode) {
-    clear();
-    for (int i = 0; i < total_tasks; i++) {
-        if (i == selected_task_index) {
-            attron(A_REVERSE);
-        }
-        mvprintw(i, 0, "%d. [%c] %s", i + 1, task_list[i].is_completed ? 'x' : ' ', task_list[i].name);
-        if (i == selected_task_index) {
-            attroff(A_REVERSE);
+    (void)is_in_subtask_mode;
+    int height = render_pane_height(PANE_TASKS);
+    int width = render_pane_width(PANE_TASKS);
+    int length;
+    render_begin(PANE_TASKS);
+
+    if (view_is_active()) {
+        view_update(task_list, total_tasks);
+        int count = view_row_count();
+        render_line(PANE_TASKS, 0, A_BOLD, "-- %s (%d of %d) --", view_title(), count, total_tasks);
+        viewport_follow(&task_viewport, view_position_of(selected_task_index), count, height - 1);
+        for (int row = 0; row < height - 1 && task_viewport.offset + row < count; row++) {
+            int task = view_row(task_viewport.offset + row);
+            const char *text = row_cache_task_row(task_list, task, width, &length);
+            render_text(PANE_TASKS, row + 1, row_attributes(task, selected_task_index), text, length);
         }
+        return;
+    }
+
+    viewport_follow(&task_viewport, selected_task_index, total_tasks, height);
+    for (int row = 0; row < height && task_viewport.offset + row < total_tasks; row++) {
+        int i = task_viewport.offset + row;
+        const char *text = row_cache_task_row(task_list, i, width, &length);
+        render_text(PANE_TASKS, row, row_attributes(i, selected_task_index), text, length);
     }
-    refresh();
 }
 
 void display_metadata(Task task_list[], int selected_task_index) {
-    clear();
-    mvprintw(0, 0, "Task: %s", task_list[selected_task_index].name);
-    mvprintw(1, 0, "Description: %s", task_list[selected_task_index].description);
-    mvprintw(2, 0, "Deadline: %s", task_list[selected_task_index].deadline);
-    refresh();
+    Task *task = &task_list[selected_task_index];
+
+    render_begin(PANE_DESCRIPTION);
+    render_line(PANE_DESCRIPTION, 0, A_BOLD, "%s", task->name);
+    render_line(PANE_DESCRIPTION, 1, A_NORMAL, "%s", task->description);
+
+    render_begin(PANE_DEADLINE);
+    render_line(PANE_DEADLINE, 0, A_NORMAL, "%s", task->deadline);
+
+    render_begin(PANE_CATEGORIES);
+    for (int i = 0; i < task->category_count; i++) {
+        render_line(PANE_CATEGORIES, i, A_NORMAL, "%s (%d)", task->categories[i], bitmap_category_count(task->categories[i]));
+    }
 }
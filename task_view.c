@@ -0,0 +1,95 @@
+#include "task_view.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int *rows = NULL;
+static int row_count = 0;
+static int row_capacity = 0;
+static bool is_active = false;
+static bool is_dirty = false;
+static ViewRefresh refresh_rows = NULL;
+static char title[64] = "";
+
+// Row of the last task looked up, so stepping and paging stay O(1).
+static int cached_position = 0;
+
+void view_open(const char *new_title, ViewRefresh refresh) {
+    strncpy(title, new_title, sizeof(title) - 1);
+    title[sizeof(title) - 1] = '\0';
+    refresh_rows = refresh;
+    is_active = true;
+    is_dirty = true;
+}
+
+void view_close(void) {
+    is_active = false;
+    row_count = 0;
+}
+
+bool view_is_active(void) {
+    return is_active;
+}
+
+void view_mark_dirty(void) {
+    is_dirty = true;
+}
+
+void view_update(Task task_list[], int total_tasks) {
+    if (!is_active || !is_dirty) return;
+    refresh_rows(task_list, total_tasks);
+    is_dirty = false;
+}
+
+void view_reset_rows(void) {
+    row_count = 0;
+}
+
+void view_add_row(int task) {
+    if (row_count == row_capacity) {
+        row_capacity = row_capacity ? row_capacity * 2 : 128;
+        rows = realloc(rows, row_capacity * sizeof(int));
+    }
+    rows[row_count++] = task;
+}
+
+int view_row_count(void) {
+    return row_count;
+}
+
+int view_row(int position) {
+    return rows[position];
+}
+
+const char *view_title(void) {
+    return title;
+}
+
+// Row of task in the view, -1 if it is not part of it.
+int view_position_of(int task) {
+    if (cached_position < row_count && rows[cached_position] == task) return cached_position;
+    for (int i = 0; i < row_count; i++) {
+        if (rows[i] == task) {
+            cached_position = i;
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Moves the selection to the row distance rows further down (up if
+// negative), clamped to the view, or onto its first row if the selected
+// task is not part of the view.
+void view_step(int distance, int *selected_task_index) {
+    if (row_count == 0) return;
+
+    int position = view_position_of(*selected_task_index);
+    if (position < 0) {
+        position = 0;
+    } else {
+        position += distance;
+        if (position < 0) position = 0;
+        if (position >= row_count) position = row_count - 1;
+    }
+    cached_position = position;
+    *selected_task_index = rows[position];
+}
@@ -0,0 +1,25 @@
+#ifndef TASK_VIEW_H
+#define TASK_VIEW_H
+
+#include "task_manager.h"
+
+// A subset of tasks shown in the task list instead of all of them (a
+// filter result, a deadline bucket, ...).  The owner supplies a refresh
+// function that rebuilds the rows with view_reset_rows/view_add_row; it
+// runs lazily, the next time the view is drawn after tasks changed.
+typedef void (*ViewRefresh)(Task task_list[], int total_tasks);
+
+void view_open(const char *title, ViewRefresh refresh);
+void view_close(void);
+bool view_is_active(void);
+void view_mark_dirty(void);
+void view_update(Task task_list[], int total_tasks);
+void view_reset_rows(void);
+void view_add_row(int task);
+int view_row_count(void);
+int view_row(int position);
+const char *view_title(void);
+int view_position_of(int task);
+void view_step(int distance, int *selected_task_index);
+
+#endif
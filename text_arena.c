@@ -0,0 +1,238 @@
+#include "text_arena.h"
+#include "scan_kernel.h"
+#include "text_fold.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define FIELD_SEPARATOR '\n'
+
+typedef struct {
+    size_t offset;
+    int length;
+    int task;
+    int category_count;
+} ArenaRecord;
+
+static char *arena = NULL;
+static size_t arena_size = 0;
+static size_t arena_capacity = 0;
+static size_t dead_bytes = 0;
+
+// Records in arena order; dead ones have task == -1.
+static ArenaRecord *records = NULL;
+static int record_count = 0;
+static int record_capacity = 0;
+
+// Live record of each task.
+static int *task_record = NULL;
+static int task_count = 0;
+static int task_capacity = 0;
+
+static int *found = NULL;
+static int found_capacity = 0;
+
+static void reserve_arena(size_t extra) {
+    if (arena_size + extra + SCAN_PADDING <= arena_capacity) return;
+    size_t new_capacity = arena_capacity ? arena_capacity : 4096;
+    while (new_capacity < arena_size + extra + SCAN_PADDING) new_capacity *= 2;
+    arena = realloc(arena, new_capacity);
+    arena_capacity = new_capacity;
+}
+
+static void append_text(const char *text) {
+    size_t length = strlen(text);
+    reserve_arena(length + 1);
+    arena_size += fold_text(text, arena + arena_size, length + 1);
+    arena[arena_size++] = FIELD_SEPARATOR;
+}
+
+static void set_task_record(int index, int record) {
+    if (index >= task_capacity) {
+        task_capacity = task_capacity ? task_capacity * 2 : 128;
+        while (task_capacity <= index) task_capacity *= 2;
+        task_record = realloc(task_record, task_capacity * sizeof(int));
+    }
+    if (index >= task_count) task_count = index + 1;
+    task_record[index] = record;
+}
+
+static void append_record(Task *task, int index) {
+    if (record_count == record_capacity) {
+        record_capacity = record_capacity ? record_capacity * 2 : 128;
+        records = realloc(records, record_capacity * sizeof(ArenaRecord));
+    }
+    ArenaRecord *record = &records[record_count];
+    record->offset = arena_size;
+    record->task = index;
+    record->category_count = task->category_count;
+
+    append_text(task->name);
+    append_text(task->description);
+    for (int i = 0; i < task->category_count; i++) {
+        append_text(task->categories[i]);
+    }
+    for (int i = 0; i < task->subtask_count; i++) {
+        append_text(task->subtasks[i].name);
+    }
+    reserve_arena(1);
+    arena[arena_size++] = '\0';
+    record->length = (int)(arena_size - record->offset);
+    memset(arena + arena_size, 0, SCAN_PADDING);
+
+    set_task_record(index, record_count++);
+}
+
+static void kill_record(int index) {
+    ArenaRecord *record = &records[task_record[index]];
+    record->task = -1;
+    dead_bytes += record->length;
+}
+
+// Rewrites the arena with only the live records, in task order.
+static void compact(void) {
+    char *old_arena = arena;
+    ArenaRecord *old_records = records;
+    size_t live_bytes = arena_size - dead_bytes;
+
+    arena_capacity = live_bytes + SCAN_PADDING;
+    arena = malloc(arena_capacity);
+    records = malloc((task_count > 0 ? task_count : 1) * sizeof(ArenaRecord));
+    record_capacity = task_count > 0 ? task_count : 1;
+    arena_size = 0;
+
+    for (int i = 0; i < task_count; i++) {
+        ArenaRecord *record = &old_records[task_record[i]];
+        memcpy(arena + arena_size, old_arena + record->offset, record->length);
+        records[i].offset = arena_size;
+        records[i].length = record->length;
+        records[i].task = i;
+        records[i].category_count = record->category_count;
+        task_record[i] = i;
+        arena_size += record->length;
+    }
+    memset(arena + arena_size, 0, SCAN_PADDING);
+    record_count = task_count;
+    dead_bytes = 0;
+
+    free(old_arena);
+    free(old_records);
+}
+
+static void maybe_compact(void) {
+    if (dead_bytes > 4096 && dead_bytes * 2 > arena_size) compact();
+}
+
+void text_arena_build(Task task_list[], int total_tasks) {
+    arena_size = 0;
+    record_count = 0;
+    task_count = 0;
+    dead_bytes = 0;
+    reserve_arena(0);
+    memset(arena, 0, SCAN_PADDING);
+    for (int i = 0; i < total_tasks; i++) {
+        append_record(&task_list[i], i);
+    }
+}
+
+void text_arena_task_changed(Task task_list[], int index) {
+    if (index < task_count) kill_record(index);
+    append_record(&task_list[index], index);
+    maybe_compact();
+}
+
+void text_arena_task_removed(int index) {
+    if (index >= task_count) return;
+    kill_record(index);
+    memmove(&task_record[index], &task_record[index + 1], (task_count - index - 1) * sizeof(int));
+    task_count--;
+    for (int r = 0; r < record_count; r++) {
+        if (records[r].task > index) records[r].task--;
+    }
+    maybe_compact();
+}
+
+static int compare_ints(const void *a, const void *b) {
+    return *(const int *)a - *(const int *)b;
+}
+
+// needle must already be folded.  Fills *tasks with the ascending
+// indexes of the tasks whose text contains it.
+int text_arena_find(const char *needle, int **tasks) {
+    size_t needle_length = strlen(needle);
+    int count = 0;
+    size_t position = 0;
+    int record = 0;
+
+    while (needle_length > 0 && position < arena_size) {
+        const char *hit = scan_find(arena + position, arena_size - position, needle, needle_length);
+        if (hit == NULL) break;
+
+        size_t offset = hit - arena;
+        while (records[record].offset + records[record].length <= offset) record++;
+        if (records[record].task >= 0) {
+            if (count == found_capacity) {
+                found_capacity = found_capacity ? found_capacity * 2 : 64;
+                found = realloc(found, found_capacity * sizeof(int));
+            }
+            found[count++] = records[record].task;
+        }
+        // One hit per record is enough; resume at the next record.
+        position = records[record].offset + records[record].length;
+    }
+
+    qsort(found, count, sizeof(int), compare_ints);
+    *tasks = found;
+    return count;
+}
+
+// Splits the record of task into its fields, in the order name,
+// description, categories, subtask names.
+int text_arena_segments(int task, TextSegment segments[]) {
+    if (task >= task_count) return 0;
+    const ArenaRecord *record = &records[task_record[task]];
+    const char *cursor = arena + record->offset;
+    const char *end = cursor + record->length - 1;
+    int count = 0;
+
+    while (cursor < end && count < TEXT_MAX_SEGMENTS) {
+        const char *separator = memchr(cursor, FIELD_SEPARATOR, end - cursor);
+        segments[count].text = cursor;
+        segments[count].length = (int)(separator - cursor);
+        if (count == 0) segments[count].field = FIELD_NAME;
+        else if (count == 1) segments[count].field = FIELD_DESCRIPTION;
+        else if (count < 2 + record->category_count) segments[count].field = FIELD_CATEGORY;
+        else segments[count].field = FIELD_SUBTASK;
+        count++;
+        cursor = separator + 1;
+    }
+    return count;
+}
+
+const char *text_arena_name(int task, int *length) {
+    if (task >= task_count) {
+        *length = 0;
+        return "";
+    }
+    const char *name = arena + records[task_record[task]].offset;
+    *length = (int)((const char *)memchr(name, FIELD_SEPARATOR, records[task_record[task]].length) - name);
+    return name;
+}
+
+// needle must already be folded.  Returns the FIELD_* mask of the fields
+// of task that contain it.
+int task_match_fields(int task, const char *needle) {
+    TextSegment segments[TEXT_MAX_SEGMENTS];
+    int count = text_arena_segments(task, segments);
+    size_t needle_length = strlen(needle);
+    int fields = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (fields & segments[i].field) continue;
+        // The arena is padded, so the vector kernel may read past the end
+        // of a segment without leaving the buffer.
+        if (scan_find(segments[i].text, segments[i].length, needle, needle_length)) {
+            fields |= segments[i].field;
+        }
+    }
+    return fields;
+}
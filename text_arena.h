@@ -0,0 +1,39 @@
+#ifndef TEXT_ARENA_H
+#define TEXT_ARENA_H
+
+#include "task_manager.h"
+
+#define FIELD_NAME 1
+#define FIELD_CATEGORY 2
+#define FIELD_SUBTASK 4
+#define FIELD_DESCRIPTION 8
+
+#define TEXT_MAX_SEGMENTS 62
+
+typedef struct {
+    const char *text;
+    int length;
+    int field;
+} TextSegment;
+
+// All searchable text of every task (name, description, categories and
+// subtask names) packed back to back in one buffer, one record per task,
+// so brute-force substring search is a single linear scan instead of a
+// walk over scattered fields of 3 KB Task records.
+//
+// The text is stored folded (see text_fold.h), which makes the arena the
+// cache every search path matches against: queries are folded once and
+// then compared byte for byte, with no per-query case or letter-variant
+// handling.
+//
+// Edited tasks get a fresh record appended at the end; the stale copies
+// are squeezed out once they make up half of the arena.
+void text_arena_build(Task task_list[], int total_tasks);
+void text_arena_task_changed(Task task_list[], int index);
+void text_arena_task_removed(int index);
+int text_arena_find(const char *needle, int **tasks);
+int text_arena_segments(int task, TextSegment segments[]);
+const char *text_arena_name(int task, int *length);
+int task_match_fields(int task, const char *needle);
+
+#endif
@@ -0,0 +1,106 @@
+#include "text_fold.h"
+
+// Returns the folded code point, or 0 if the character is dropped.
+static unsigned int fold_codepoint(unsigned int cp) {
+    if (cp < 0x80) {
+        return (cp >= 'A' && cp <= 'Z') ? cp + 32 : cp;
+    }
+    if ((cp >= 0xC0 && cp <= 0xDE && cp != 0xD7) ||
+        (cp >= 0x391 && cp <= 0x3AB && cp != 0x3A2) ||
+        (cp >= 0x410 && cp <= 0x42F)) {
+        return cp + 32;
+    }
+    if (cp >= 0x400 && cp <= 0x40F) return cp + 80;
+
+    switch (cp) {
+        case 0x064A:
+        case 0x0649:
+        case 0x0626:
+            return 0x06CC;
+        case 0x0643:
+            return 0x06A9;
+        case 0x0629:
+        case 0x06C0:
+            return 0x0647;
+        case 0x0622:
+        case 0x0623:
+        case 0x0625:
+        case 0x0671:
+            return 0x0627;
+        case 0x0624:
+            return 0x0648;
+        case 0x0640:
+        case 0x0670:
+        case 0x200C:
+        case 0x200D:
+            return 0;
+    }
+    if (cp >= 0x064B && cp <= 0x065F) return 0;
+    if (cp >= 0x06F0 && cp <= 0x06F9) return '0' + (cp - 0x06F0);
+    if (cp >= 0x0660 && cp <= 0x0669) return '0' + (cp - 0x0660);
+    return cp;
+}
+
+static int encode_utf8(unsigned int cp, char *out) {
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+int fold_text(const char *input, char *output, int output_size) {
+    const unsigned char *in = (const unsigned char *)input;
+    int length = 0;
+
+    while (*in) {
+        unsigned int cp;
+        int size;
+        if (in[0] < 0x80) {
+            cp = in[0];
+            size = 1;
+        } else if ((in[0] & 0xE0) == 0xC0 && (in[1] & 0xC0) == 0x80) {
+            cp = (in[0] & 0x1F) << 6 | (in[1] & 0x3F);
+            size = 2;
+        } else if ((in[0] & 0xF0) == 0xE0 && (in[1] & 0xC0) == 0x80 && (in[2] & 0xC0) == 0x80) {
+            cp = (in[0] & 0x0F) << 12 | (in[1] & 0x3F) << 6 | (in[2] & 0x3F);
+            size = 3;
+        } else if ((in[0] & 0xF8) == 0xF0 && (in[1] & 0xC0) == 0x80 && (in[2] & 0xC0) == 0x80 && (in[3] & 0xC0) == 0x80) {
+            cp = (in[0] & 0x07) << 18 | (in[1] & 0x3F) << 12 | (in[2] & 0x3F) << 6 | (in[3] & 0x3F);
+            size = 4;
+        } else {
+            // Not valid UTF-8: pass the byte through unchanged.
+            if (length + 1 >= output_size) break;
+            output[length++] = (char)*in++;
+            continue;
+        }
+        in += size;
+
+        unsigned int folded = fold_codepoint(cp);
+        if (folded == 0) continue;
+
+        char encoded[4];
+        int encoded_size = encode_utf8(folded, encoded);
+        if (length + encoded_size >= output_size) break;
+        for (int i = 0; i < encoded_size; i++) {
+            output[length++] = encoded[i];
+        }
+    }
+    output[length] = '\0';
+    return length;
+}
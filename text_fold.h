@@ -0,0 +1,11 @@
+#ifndef TEXT_FOLD_H
+#define TEXT_FOLD_H
+
+// Normalises UTF-8 text for matching: case-folds Latin, Greek and Cyrillic
+// letters, unifies Arabic and Persian letter variants (ي/ى -> ی, ك -> ک,
+// ة/ۀ -> ه, أ/إ/آ/ٱ -> ا, ؤ -> و, ئ -> ی), maps Persian and Arabic-Indic
+// digits to ASCII and drops diacritics, tatweel and zero-width joiners.
+// The result is never longer than the input.  Returns its length.
+int fold_text(const char *input, char *output, int output_size);
+
+#endif
@@ -0,0 +1,241 @@
+#include "trigram_index.h"
+#include "task_ids.h"
+#include "text_arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_NEEDLE_LENGTH 100
+
+typedef struct {
+    unsigned int key;
+    // Task ids (see task_ids.h), ascending.
+    int *tasks;
+    int count;
+    int capacity;
+} TrigramEntry;
+
+static TrigramEntry *trigrams = NULL;
+static int trigram_count = 0;
+static int trigram_capacity = 0;
+
+// Open addressing over trigram ids, stored +1 so that 0 marks an empty slot.
+static int *table = NULL;
+static int table_size = 0;
+
+static TermLists forward = { NULL, 0, 0 };
+
+static int *candidates = NULL;
+static int candidate_capacity = 0;
+static SearchHit *hits_buffer = NULL;
+static int hits_capacity = 0;
+
+static unsigned int hash_key(unsigned int key) {
+    key ^= key >> 13;
+    key *= 0x5bd1e995u;
+    key ^= key >> 15;
+    return key;
+}
+
+static unsigned int make_key(const char *text) {
+    return (unsigned int)(unsigned char)text[0] << 16 |
+           (unsigned int)(unsigned char)text[1] << 8 |
+           (unsigned int)(unsigned char)text[2];
+}
+
+static void grow_table(void) {
+    int new_size = table_size ? table_size * 2 : 4096;
+    int *new_table = calloc(new_size, sizeof(int));
+    for (int id = 0; id < trigram_count; id++) {
+        unsigned int slot = hash_key(trigrams[id].key) & (new_size - 1);
+        while (new_table[slot]) slot = (slot + 1) & (new_size - 1);
+        new_table[slot] = id + 1;
+    }
+    free(table);
+    table = new_table;
+    table_size = new_size;
+}
+
+static int find_trigram(unsigned int key) {
+    if (table_size == 0) return -1;
+    unsigned int slot = hash_key(key) & (table_size - 1);
+    while (table[slot]) {
+        int id = table[slot] - 1;
+        if (trigrams[id].key == key) return id;
+        slot = (slot + 1) & (table_size - 1);
+    }
+    return -1;
+}
+
+static int intern_trigram(unsigned int key) {
+    int id = find_trigram(key);
+    if (id >= 0) return id;
+
+    if ((trigram_count + 1) * 10 >= table_size * 7) grow_table();
+    if (trigram_count == trigram_capacity) {
+        trigram_capacity = trigram_capacity ? trigram_capacity * 2 : 1024;
+        trigrams = realloc(trigrams, trigram_capacity * sizeof(TrigramEntry));
+    }
+    id = trigram_count++;
+    trigrams[id].key = key;
+    trigrams[id].tasks = NULL;
+    trigrams[id].count = 0;
+    trigrams[id].capacity = 0;
+
+    unsigned int slot = hash_key(key) & (table_size - 1);
+    while (table[slot]) slot = (slot + 1) & (table_size - 1);
+    table[slot] = id + 1;
+    return id;
+}
+
+// Index of the first entry in tasks[from..count) that is >= task.
+static int lower_bound(const int *tasks, int from, int count, int task) {
+    int low = from, high = count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (tasks[mid] < task) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+static void add_text(int index, int task_id, const char *text, int length) {
+    for (int i = 0; i + 3 <= length; i++) {
+        int id = intern_trigram(make_key(text + i));
+        TrigramEntry *entry = &trigrams[id];
+        int pos = lower_bound(entry->tasks, 0, entry->count, task_id);
+        if (pos < entry->count && entry->tasks[pos] == task_id) continue;
+
+        if (entry->count == entry->capacity) {
+            entry->capacity = entry->capacity ? entry->capacity * 2 : 4;
+            entry->tasks = realloc(entry->tasks, entry->capacity * sizeof(int));
+        }
+        memmove(&entry->tasks[pos + 1], &entry->tasks[pos], (entry->count - pos) * sizeof(int));
+        entry->tasks[pos] = task_id;
+        entry->count++;
+
+        term_list_push(term_lists_at(&forward, index), id);
+    }
+}
+
+static void add_task(int index) {
+    TextSegment segments[TEXT_MAX_SEGMENTS];
+    int count = text_arena_segments(index, segments);
+    term_lists_at(&forward, index);
+    int task_id = task_id_at(index);
+    for (int i = 0; i < count; i++) {
+        add_text(index, task_id, segments[i].text, segments[i].length);
+    }
+}
+
+static void remove_task(int index) {
+    if (index >= forward.count) return;
+    TermList *list = &forward.lists[index];
+    int task_id = task_id_at(index);
+    for (int i = 0; i < list->count; i++) {
+        TrigramEntry *entry = &trigrams[list->ids[i]];
+        int pos = lower_bound(entry->tasks, 0, entry->count, task_id);
+        if (pos < entry->count && entry->tasks[pos] == task_id) {
+            memmove(&entry->tasks[pos], &entry->tasks[pos + 1], (entry->count - pos - 1) * sizeof(int));
+            entry->count--;
+        }
+    }
+    list->count = 0;
+}
+
+void trigram_index_build(Task task_list[], int total_tasks) {
+    for (int id = 0; id < trigram_count; id++) {
+        trigrams[id].count = 0;
+    }
+    term_lists_reset(&forward, total_tasks);
+    (void)task_list;
+    for (int i = 0; i < total_tasks; i++) {
+        add_task(i);
+    }
+}
+
+void trigram_index_task_changed(Task task_list[], int index) {
+    (void)task_list;
+    remove_task(index);
+    add_task(index);
+}
+
+void trigram_index_task_removed(int index) {
+    remove_task(index);
+    term_lists_removed(&forward, index);
+}
+
+static void reserve_buffers(int count) {
+    if (count > candidate_capacity) {
+        candidate_capacity = count;
+        candidates = realloc(candidates, candidate_capacity * sizeof(int));
+    }
+    if (count > hits_capacity) {
+        hits_capacity = count;
+        hits_buffer = realloc(hits_buffer, hits_capacity * sizeof(SearchHit));
+    }
+}
+
+// needle must already be folded.
+int trigram_index_query(int total_tasks, const char *needle, SearchHit **hits) {
+    char bounded[MAX_NEEDLE_LENGTH];
+    int length = 0;
+    while (needle[length] && length < MAX_NEEDLE_LENGTH - 1) {
+        bounded[length] = needle[length];
+        length++;
+    }
+    bounded[length] = '\0';
+    *hits = hits_buffer;
+    if (length == 0) return 0;
+
+    int candidate_count;
+    if (length < 3) {
+        int *found;
+        candidate_count = text_arena_find(bounded, &found);
+        reserve_buffers(candidate_count);
+        memcpy(candidates, found, candidate_count * sizeof(int));
+    } else {
+        TrigramEntry *lists[MAX_NEEDLE_LENGTH];
+        int list_count = 0;
+        for (int i = 0; i + 3 <= length; i++) {
+            int id = find_trigram(make_key(bounded + i));
+            if (id < 0 || trigrams[id].count == 0) return 0;
+            lists[list_count++] = &trigrams[id];
+        }
+
+        int shortest = 0;
+        for (int i = 1; i < list_count; i++) {
+            if (lists[i]->count < lists[shortest]->count) shortest = i;
+        }
+        reserve_buffers(lists[shortest]->count);
+        memcpy(candidates, lists[shortest]->tasks, lists[shortest]->count * sizeof(int));
+        candidate_count = lists[shortest]->count;
+
+        for (int i = 0; i < list_count && candidate_count > 0; i++) {
+            if (i == shortest || lists[i] == lists[shortest]) continue;
+            int kept = 0, from = 0;
+            for (int c = 0; c < candidate_count; c++) {
+                from = lower_bound(lists[i]->tasks, from, lists[i]->count, candidates[c]);
+                if (from == lists[i]->count) break;
+                if (lists[i]->tasks[from] == candidates[c]) candidates[kept++] = candidates[c];
+            }
+            candidate_count = kept;
+        }
+
+        for (int c = 0; c < candidate_count; c++) {
+            candidates[c] = task_index_of(candidates[c]);
+        }
+    }
+
+    int hit_count = 0;
+    for (int c = 0; c < candidate_count; c++) {
+        if (candidates[c] >= total_tasks) continue;
+        int fields = task_match_fields(candidates[c], bounded);
+        if (fields) {
+            hits_buffer[hit_count].task = candidates[c];
+            hits_buffer[hit_count].score = search_field_weight(fields);
+            hit_count++;
+        }
+    }
+    *hits = hits_buffer;
+    return hit_count;
+}
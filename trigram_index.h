@@ -0,0 +1,18 @@
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+
+#include "task_manager.h"
+#include "search_index.h"
+
+// Trigram posting lists over the folded task and subtask text in the text
+// arena (which must be updated before this index), used to answer
+// case-insensitive substring queries.  Posting lists of the needle's
+// trigrams are intersected first, so only the surviving candidates are
+// verified against the actual text.  Needles shorter than a trigram fall
+// back to a brute-force scan of the text arena.
+void trigram_index_build(Task task_list[], int total_tasks);
+void trigram_index_task_changed(Task task_list[], int index);
+void trigram_index_task_removed(int index);
+int trigram_index_query(int total_tasks, const char *needle, SearchHit **hits);
+
+#endif
@@ -1,5 +1,21 @@
 #include "ui_controll.h"
 #include "task_manager.h"
+#include "task_events.h"
+#include "next_up.h"
+#include "search.h"
+#include "filter.h"
+#include "task_view.h"
+#include "deadline_index.h"
+#include "render.h"
+#include "perf.h"
+#include "event_loop.h"
+#include "form.h"
+#include "macro.h"
+#include "marks.h"
+#include "file_watch.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <ncurses.h>
 
 void initialize_ui() {
@@ -8,134 +24,528 @@ void initialize_ui() {
     noecho();
     keypad(stdscr, TRUE);
     curs_set(0);
+    render_init();
 }
 
+static const char *help_lines[] = {
+    "Keys: 'q' quit, 'a' add, 'd' delete, 'SPACE' toggle status, 's' sort",
+    " 'j'/'k' navigate, PgUp/PgDn/'g'/'G' scroll, 'l' subtasks, 'h' back to tasks",
+    " 'e' edit name, 'r' edit description, 't' new deadline, 'c' edit categories",
+    " 'P' set priority, 'm' mark/unmark for bulk changes, 'U' unmark all",
+    " 'w' save, 'x' load, 'u' what's next, 'p' performance overlay",
+    " 'M' start/stop recording a macro, '@' replay it",
+    " '/' search (Tab for fuzzy), 'n'/'N' next/previous match",
+    " 'f' filter (e.g. cat:Work prio<=3 due<01/03/2025 !done \"text\"; empty to clear)",
+    " 'O' overdue, 'T' due today, 'W' due this week, 'R' date range, 'A' all tasks",
+};
+
+// Lays the panes out for the current terminal size and redraws what lives
+// on stdscr around them.  Called at start-up and on every resize; only the
+// screen is rebuilt, never the task data or its indexes.
 void draw_ui() {
+    int help_count = sizeof(help_lines) / sizeof(help_lines[0]);
+    int shown = render_layout(help_count);
+
     clear();
-    refresh();
+    for (int i = 0; i < shown; i++) {
+        mvaddnstr(status_row - shown + i, 0, help_lines[i], COLS);
+    }
+    render_invalidate();
+}
+
+static void select_first_view_row(Task task_list[], int total_tasks, int *selected_task_index) {
+    if (!view_is_active()) return;
+    view_update(task_list, total_tasks);
+    if (view_row_count() > 0) {
+        *selected_task_index = view_row(0);
+    }
+}
+
+// Search-as-you-type: every keystroke re-runs the search, which narrows the
+// previous matches while the query only grows.  Tab switches between exact
+// and fuzzy matching.  Enter keeps the selection, Escape puts it back where
+// it was.
+static int next_key(void);
+
+// Set while the search prompt is open, which works on its own copy of
+// the task count.
+static bool is_live_search_open = false;
+
+static void run_live_search(Task task_list[], int total_tasks, int *selected_task_index, bool is_in_subtask_mode) {
+    char query[100] = "";
+    int length = 0;
+    int original_selection = *selected_task_index;
+
+    search_clear();
+    curs_set(1);
+    is_live_search_open = true;
+    for (;;) {
+        // Timed like render_frame, so keys typed into the query count
+        // towards key-to-paint latency.
+        double started = perf_now();
+        bool is_drawn = !macro_is_replaying();
+        if (is_drawn) {
+            display_tasks(task_list, total_tasks, *selected_task_index, is_in_subtask_mode);
+            render_flush();
+        }
+        move(status_row, 0);
+        clrtobot();
+        const char *prompt = search_is_fuzzy() ? "Fuzzy: " : "Search: ";
+        mvprintw(status_row, 0, "%s%s", prompt, query);
+        if (length > 0) {
+            mvprintw(status_row + 1, 0, "%d match(es)", search_match_count());
+        }
+        move(status_row, strlen(prompt) + length);
+        refresh();
+        if (is_drawn) perf_frame_done(started);
+
+        // Timers keep running while the query is typed.
+        int ch = next_key();
+        if (ch == ERR) {
+            break;
+        } else if (ch == KEY_RESIZE) {
+            draw_ui();
+            continue;
+        } else if (ch == EVENT_FRAME) {
+            continue;
+        } else if (ch == '\n' || ch == KEY_ENTER) {
+            break;
+        } else if (ch == 27) {
+            search_clear();
+            *selected_task_index = original_selection;
+            break;
+        } else if (ch == KEY_BACKSPACE || ch == 127 || ch == '\b') {
+            if (length == 0) continue;
+            query[--length] = '\0';
+        } else if (ch == '\t') {
+            search_set_fuzzy(!search_is_fuzzy());
+        } else if (ch >= ' ' && ch < KEY_MIN && length < (int)sizeof(query) - 1) {
+            query[length++] = (char)ch;
+            query[length] = '\0';
+        } else {
+            continue;
+        }
+
+        if (length == 0) {
+            search_clear();
+            *selected_task_index = original_selection;
+        } else {
+            search_tasks(task_list, total_tasks, query, selected_task_index);
+        }
+    }
+    is_live_search_open = false;
+    curs_set(0);
+}
+
+static void render_frame(Task task_list[], int total_tasks, int selected_task_index, int selected_subtask_index, bool is_in_subtask_mode, bool show_next_up) {
+    double started = perf_now();
+    display_tasks(task_list, total_tasks, selected_task_index, is_in_subtask_mode);
+    if (show_next_up) {
+        display_next_up(task_list, total_tasks);
+    } else {
+        display_subtasks(task_list, selected_task_index, is_in_subtask_mode ? selected_subtask_index : -1);
+    }
+    display_metadata(task_list, selected_task_index);
+    if (form_is_active()) {
+        form_draw(status_row);
+    }
+    if (macro_is_recording()) {
+        mvprintw(status_row + 2, 0, "Recording macro: %d key(s), 'M' to stop", macro_length());
+    } else if (marks_count() > 0) {
+        mvprintw(status_row + 2, 0, "%d marked: 'd', SPACE, 't', 'c', 'P' and '@' apply to them, 'U' unmarks", marks_count());
+    }
+    if (perf_overlay_enabled()) {
+        perf_draw_overlay(status_row + STATUS_LINES - 1);
+    }
+    render_flush();
+    perf_frame_done(started);
+}
+
+// Far enough to reach either end of any list in one step.
+#define SELECTION_END (1 << 24)
+
+// Moves the selection distance rows down (up if negative) in whichever
+// list has focus, clamped to its ends.  Whole pages and jumps to either end
+// are a single clamp, independent of the list length.
+static void move_selection(Task task_list[], int total_tasks, int *selected_task_index, int *selected_subtask_index, bool is_in_subtask_mode, int distance) {
+    int position, count;
+    if (is_in_subtask_mode) {
+        position = *selected_subtask_index;
+        count = task_list[*selected_task_index].subtask_count;
+    } else if (view_is_active()) {
+        view_update(task_list, total_tasks);
+        view_step(distance, selected_task_index);
+        return;
+    } else {
+        position = *selected_task_index;
+        count = total_tasks;
+    }
+    if (count == 0) return;
+
+    position += distance;
+    if (position < 0) position = 0;
+    if (position >= count) position = count - 1;
+    if (is_in_subtask_mode) {
+        *selected_subtask_index = position;
+    } else {
+        *selected_task_index = position;
+    }
+}
+
+// Held keys and pasted command sequences arrive faster than frames can be
+// drawn.  key_pending() peeks without blocking so the loop applies the
+// whole burst and only renders once the input queue is empty.
+static int pending_key = ERR;
+
+static bool key_pending(void) {
+    if (macro_is_replaying()) return true;
+    if (pending_key == ERR) {
+        nodelay(stdscr, TRUE);
+        pending_key = getch();
+        nodelay(stdscr, FALSE);
+        if (pending_key != ERR) perf_key_read();
+    }
+    return pending_key != ERR;
+}
+
+// Keys come from a macro being replayed first, then from the terminal;
+// the terminal's are recorded while a macro is being recorded.
+static int next_key(void) {
+    if (macro_is_replaying()) return macro_next_key();
+
+    int ch;
+    if (pending_key != ERR) {
+        ch = pending_key;
+        pending_key = ERR;
+    } else {
+        ch = event_loop_next_key();
+        if (ch == EVENT_FRAME || ch == ERR) return ch;
+        perf_key_read();
+    }
+    if (ch != KEY_RESIZE) macro_record(ch);
+    return ch;
+}
+
+static void schedule_day_change(void);
+
+// Due dates and next-up urgency are relative to today, so the first frame
+// of a new day is drawn even if nobody touches a key.
+static void day_changed(void *context) {
+    (void)context;
+    view_mark_dirty();
+    event_loop_request_frame();
+    schedule_day_change();
+}
+
+static void schedule_day_change(void) {
+    time_t now = time(NULL);
+    struct tm midnight = *localtime(&now);
+    midnight.tm_mday++;
+    midnight.tm_hour = 0;
+    midnight.tm_min = 0;
+    midnight.tm_sec = 0;
+    midnight.tm_isdst = -1;
+    event_loop_add_timer(difftime(mktime(&midnight), now) * 1000, day_changed, NULL);
+}
+
+// The task list the input loop works on, for forms submitted from it.
+static Task *loop_tasks;
+static int *loop_total_tasks;
+static int *loop_selected_task;
+static int *loop_selected_subtask;
 
-    WINDOW *task_window = newwin(15, 40, 0, 0);
-    box(task_window, 0, 0);
-    mvwprintw(task_window, 0, 2, "Tasks");
-    wrefresh(task_window);
+// Another instance or an editor wrote tasks.json: fold its changes into
+// the list.  Our own saves leave nothing to merge.
+static void tasks_file_changed(void *context) {
+    (void)context;
+    // The open form applies to a task by its index, and the search prompt
+    // holds the task count and selection; wait until they close.
+    if (form_is_active() || is_live_search_open) {
+        event_loop_add_timer(500, tasks_file_changed, NULL);
+        return;
+    }
+
+    MergeResult result;
+    TaskStatus status = tasks_merge(loop_tasks, loop_total_tasks, "tasks.json", loop_selected_task, &result);
+    if (status == TASK_LIST_FULL) {
+        mvprintw(status_row, 0, "tasks.json changed on disk, but merging it would go over %d tasks; not merged.", MAX_TASKS);
+        event_loop_request_frame();
+        return;
+    }
+    if (status != TASK_OK || !result.changed) return;
+    int subtask_count = *loop_total_tasks > 0 ? loop_tasks[*loop_selected_task].subtask_count : 0;
+    if (*loop_selected_subtask >= subtask_count) {
+        *loop_selected_subtask = subtask_count > 0 ? subtask_count - 1 : 0;
+    }
+    mvprintw(status_row, 0, "tasks.json changed on disk: %d task(s) taken from it, %d dropped.", result.updated, result.removed);
+    event_loop_request_frame();
+}
 
-    WINDOW *subtask_window = newwin(15, 40, 0, 40);
-    box(subtask_window, 0, 0);
-    mvwprintw(subtask_window, 0, 2, "Subtasks");
-    wrefresh(subtask_window);
+static bool validate_filter(const char *value, char *error, int error_size) {
+    FilterProgram program;
+    return filter_compile(value, &program, error, error_size);
+}
 
-    WINDOW *category_window = newwin(5, 40, 15, 0);
-    box(category_window, 0, 0);
-    mvwprintw(category_window, 0, 2, "Categories");
-    wrefresh(category_window);
+static void submit_filter(char values[][FORM_VALUE_SIZE]) {
+    char error[80];
+    if (!filter_apply(values[0], error, sizeof(error))) {
+        mvprintw(status_row, 0, "%s", error);
+    } else {
+        select_first_view_row(loop_tasks, *loop_total_tasks, loop_selected_task);
+    }
+}
 
-    WINDOW *deadline_window = newwin(5, 40, 15, 40);
-    box(deadline_window, 0, 0);
-    mvwprintw(deadline_window, 0, 2, "Deadline");
-    wrefresh(deadline_window);
+static bool validate_deadline_range(const char *value, char *error, int error_size) {
+    char first[11] = "";
+    char last[11] = "";
+    if (sscanf(value, "%10s %10s", first, last) == 2 && date_to_day_number(first) >= 0 && date_to_day_number(last) >= 0) {
+        return true;
+    }
+    snprintf(error, error_size, "Enter two dates as DD/MM/YYYY DD/MM/YYYY.");
+    return false;
+}
 
-    WINDOW *description_window = newwin(5, 80, 20, 0);
-    box(description_window, 0, 0);
-    mvwprintw(description_window, 0, 2, "Description");
-    wrefresh(description_window);
+static void submit_deadline_range(char values[][FORM_VALUE_SIZE]) {
+    if (show_deadline_range_view(values[0])) {
+        select_first_view_row(loop_tasks, *loop_total_tasks, loop_selected_task);
+    }
+}
 
-    mvprintw(26, 0, "Keys: 'q' to quit, 'a' to add task, 'j'/'k' to navigate, 'd' to delete, 'SPACE' to toggle status, 's' to sort, 'l' to point subtasks, 'h' to back task,\n 'e' to edit task's name, 'r' to edit task's desciption, 'n' to add new deadline, 'c' to edit categories, 'w' to save, 'x' to retrive.");
-    refresh();
+static bool validate_replay(const char *value, char *error, int error_size) {
+    if (strcmp(value, "*") == 0) return true;
+    char *end;
+    long times = strtol(value, &end, 10);
+    if (end != value && *end == '\0' && times >= 1 && times <= 10000) return true;
+    snprintf(error, error_size, "Enter a count from 1 to 10000, or *.");
+    return false;
+}
+
+// "*" replays once per marked task, or per task shown if none are
+// marked, starting each pass with that task selected.
+static void submit_replay(char values[][FORM_VALUE_SIZE]) {
+    if (strcmp(values[0], "*") != 0) {
+        macro_replay(atoi(values[0]));
+        return;
+    }
+
+    if (marks_count() > 0) {
+        const int *marked;
+        int marked_count = marks_collect(&marked);
+        macro_replay_over(marked, marked_count);
+        return;
+    }
+
+    int count = *loop_total_tasks;
+    if (view_is_active()) {
+        view_update(loop_tasks, *loop_total_tasks);
+        count = view_row_count();
+    }
+    int *targets = malloc((count > 0 ? count : 1) * sizeof(int));
+    for (int i = 0; i < count; i++) {
+        targets[i] = view_is_active() ? view_row(i) : i;
+    }
+    macro_replay_over(targets, count);
+    free(targets);
 }
 
 void handle_user_input(Task task_list[], int *total_tasks, int *selected_task_index, int *selected_subtask_index, bool *is_in_subtask_mode) {
-    char ch;
-    while ((ch = getch()) != 'q') {
-        switch (ch) {
-            case 'a':
-                if (*is_in_subtask_mode) {
-                    add_new_subtask(task_list, *selected_task_index);
-                } else {
-                    add_new_task(task_list, total_tasks);
-                }
-                break;
-            case 'd':
-                if (*is_in_subtask_mode) {
-                    delete_selected_subtask(task_list, *selected_task_index);
-                } else {
-                    delete_selected_task(task_list, total_tasks, *selected_task_index);
-                }
-                break;
-            case 'j':
-                if (*is_in_subtask_mode) {
-                    if (*selected_subtask_index < task_list[*selected_task_index].subtask_count - 1) {
-                        (*selected_subtask_index)++;
+    int ch;
+    bool show_next_up = false;
+    loop_tasks = task_list;
+    loop_total_tasks = total_tasks;
+    loop_selected_task = selected_task_index;
+    loop_selected_subtask = selected_subtask_index;
+    schedule_day_change();
+    file_watch_start("tasks.json", tasks_file_changed, NULL);
+    render_frame(task_list, *total_tasks, *selected_task_index, *selected_subtask_index, *is_in_subtask_mode, show_next_up);
+    for (;;) {
+        ch = next_key();
+        // ERR: the terminal is gone, so quit (and save) as for 'q'.
+        if (ch == ERR || (ch == 'q' && !form_is_active())) break;
+
+        // Drop the previous command's messages and prompts.  A frame asked
+        // for by a timer keeps them, along with anything the timer printed.
+        if (ch != EVENT_FRAME) {
+            move(status_row, 0);
+            clrtobot();
+        }
+        if (ch == KEY_RESIZE) {
+            draw_ui();
+        } else if (form_is_active()) {
+            if (ch != EVENT_FRAME) form_handle_key(ch);
+        } else {
+            switch (ch) {
+                case 'a':
+                    if (*is_in_subtask_mode) {
+                        add_new_subtask(task_list, total_tasks, *selected_task_index);
+                    } else {
+                        add_new_task(task_list, total_tasks);
+                    }
+                    break;
+                case 'd':
+                    if (*is_in_subtask_mode) {
+                        delete_selected_subtask(task_list, *total_tasks, *selected_task_index, *selected_subtask_index);
+                        if (*selected_subtask_index >= task_list[*selected_task_index].subtask_count && *selected_subtask_index > 0) {
+                            (*selected_subtask_index)--;
+                        }
+                    } else if (marks_count() > 0) {
+                        delete_marked_tasks(task_list, total_tasks);
+                        if (*selected_task_index >= *total_tasks && *total_tasks > 0) {
+                            *selected_task_index = *total_tasks - 1;
+                        }
+                    } else {
+                        delete_selected_task(task_list, total_tasks, *selected_task_index);
                     }
-                } else if (*selected_task_index < *total_tasks - 1) {
-                    (*selected_task_index)++;
-                }
-                break;
-            case 'k':
-                if (*is_in_subtask_mode) {
-                    if (*selected_subtask_index > 0) {
-                        (*selected_subtask_index)--;
+                    break;
+                case 'j':
+                    move_selection(task_list, *total_tasks, selected_task_index, selected_subtask_index, *is_in_subtask_mode, 1);
+                    break;
+                case 'k':
+                    move_selection(task_list, *total_tasks, selected_task_index, selected_subtask_index, *is_in_subtask_mode, -1);
+                    break;
+                case KEY_NPAGE:
+                    move_selection(task_list, *total_tasks, selected_task_index, selected_subtask_index, *is_in_subtask_mode, render_pane_height(PANE_TASKS) - 1);
+                    break;
+                case KEY_PPAGE:
+                    move_selection(task_list, *total_tasks, selected_task_index, selected_subtask_index, *is_in_subtask_mode, 1 - render_pane_height(PANE_TASKS));
+                    break;
+                case 'g':
+                case KEY_HOME:
+                    move_selection(task_list, *total_tasks, selected_task_index, selected_subtask_index, *is_in_subtask_mode, -SELECTION_END);
+                    break;
+                case 'G':
+                case KEY_END:
+                    move_selection(task_list, *total_tasks, selected_task_index, selected_subtask_index, *is_in_subtask_mode, SELECTION_END);
+                    break;
+                case 'l':
+                    if (!*is_in_subtask_mode && *total_tasks > 0) {
+                        *is_in_subtask_mode = true;
+                        *selected_subtask_index = 0;
                     }
-                } else if (*selected_task_index > 0) {
-                    (*selected_task_index)--;
-                }
-                break;
-            case 'l':
-                if (!*is_in_subtask_mode && *total_tasks > 0) {
-                    *is_in_subtask_mode = true;
+                    break;
+                case 'h':
+                    if (*is_in_subtask_mode) {
+                        *is_in_subtask_mode = false;
+                    }
+                    break;
+                case ' ':
+                    if (*is_in_subtask_mode) {
+                        task_toggle_subtask(task_list, *total_tasks, *selected_task_index, *selected_subtask_index);
+                    } else if (marks_count() > 0) {
+                        toggle_marked_tasks(task_list, *total_tasks);
+                    } else {
+                        task_toggle(task_list, *total_tasks, *selected_task_index);
+                    }
+                    break;
+                case 's':
+                    sort_tasks(task_list, *total_tasks);
+                    break;
+                case 'e':
+                    edit_task_name(task_list, total_tasks, *selected_task_index);
+                    break;
+                case 'r':
+                    edit_task_description(task_list, total_tasks, *selected_task_index);
+                    break;
+                case 't':
+                    if (marks_count() > 0) {
+                        set_marked_deadline(task_list, total_tasks);
+                    } else {
+                        add_new_deadline(task_list, total_tasks, *selected_task_index);
+                    }
+                    break;
+                case 'P':
+                    edit_priority(task_list, total_tasks, *selected_task_index);
+                    break;
+                case 'n':
+                    search_step(*total_tasks, 1, selected_task_index);
+                    break;
+                case 'N':
+                    search_step(*total_tasks, -1, selected_task_index);
+                    break;
+                case 'c':
+                    if (marks_count() > 0) {
+                        add_marked_categories(task_list, total_tasks);
+                    } else {
+                        manage_categories(task_list, total_tasks, *selected_task_index);
+                    }
+                    break;
+                case 'm':
+                    if (!*is_in_subtask_mode && *selected_task_index < *total_tasks) {
+                        marks_toggle(*selected_task_index);
+                        move_selection(task_list, *total_tasks, selected_task_index, selected_subtask_index, false, 1);
+                    }
+                    break;
+                case 'U':
+                    marks_clear();
+                    break;
+                case 'w':
+                    save_tasks_to_file(task_list, total_tasks, "tasks.json", selected_task_index);
+                    break;
+                case 'x':
+                    load_tasks_from_file(task_list, total_tasks, "tasks.json");
+                    break;
+                case '/':
+                    run_live_search(task_list, *total_tasks, selected_task_index, *is_in_subtask_mode);
+                    break;
+                case 'f':
+                    form_open("Filter", submit_filter);
+                    form_add_field("Expression (empty to clear)", "", 99, validate_filter);
+                    break;
+                case 'O':
+                    show_overdue_view();
+                    select_first_view_row(task_list, *total_tasks, selected_task_index);
+                    break;
+                case 'T':
+                    show_due_today_view();
+                    select_first_view_row(task_list, *total_tasks, selected_task_index);
+                    break;
+                case 'W':
+                    show_due_this_week_view();
+                    select_first_view_row(task_list, *total_tasks, selected_task_index);
+                    break;
+                case 'R':
+                    form_open("Deadline range", submit_deadline_range);
+                    form_add_field("From and to (DD/MM/YYYY DD/MM/YYYY)", "", 39, validate_deadline_range);
+                    break;
+                case 'A':
+                    view_close();
+                    break;
+                case 'u':
+                    show_next_up = !show_next_up;
+                    break;
+                case 'p':
+                    perf_toggle_overlay();
+                    break;
+                case 'M':
+                    if (macro_is_recording()) {
+                        macro_stop_recording();
+                        mvprintw(status_row, 0, "Macro recorded: %d key(s).", macro_length());
+                    } else {
+                        macro_start_recording();
+                    }
+                    break;
+                case '@':
+                    if (macro_is_replaying()) {
+                        break;
+                    } else if (macro_is_recording()) {
+                        mvprintw(status_row, 0, "Stop recording ('M') before replaying.");
+                    } else if (macro_length() == 0) {
+                        mvprintw(status_row, 0, "No macro recorded. Press 'M' to record one.");
+                    } else {
+                        form_open("Replay macro", submit_replay);
+                        form_add_field("Times, or * for each marked task (all listed if none)", "1", 5, validate_replay);
+                    }
+                    break;
+                case MACRO_SELECT_TARGET:
+                    if (macro_target() >= *total_tasks) break;
+                    *selected_task_index = macro_target();
                     *selected_subtask_index = 0;
-                }
-                break;
-            case 'h':
-                if (*is_in_subtask_mode) {
                     *is_in_subtask_mode = false;
-                }
-                break;
-            case ' ':
-                if (*is_in_subtask_mode) {
-                    toggle_subtask_status(task_list, *selected_task_index, *selected_subtask_index);
-                } else {
-                    if (*total_tasks > 0) {
-                        task_list[*selected_task_index].is_completed = !task_list[*selected_task_index].is_completed;
-                    }
-                }
-                break;
-            case 's':
-                sort_tasks(task_list, *total_tasks);
-                display_tasks(task_list, *total_tasks, *selected_task_index, *is_in_subtask_mode);
-                display_metadata(task_list, *selected_task_index);
-                break;
-            case 'e':
-                edit_task_name(task_list, *selected_task_index);
-                break;
-            case 'r':
-                edit_task_description(task_list, *selected_task_index);
-                break;
-            case 'n':
-                add_new_deadline(task_list, *selected_task_index);
-                break;
-            case 'c':
-                manage_categories(task_list, *selected_task_index);
-                break;
-            case 'w':
-                save_tasks_to_file(task_list, *total_tasks, "tasks.json");
-                break;
-            case 'x':
-                load_tasks_from_file(task_list, total_tasks, "tasks.json");
-                display_metadata(task_list, *selected_task_index);
-                break;
-            case '/':
-                echo();
-                curs_set(1);
-                char query[100];
-                mvprintw(27, 0, "Enter search query: ");
-                getnstr(query, 99);
-                noecho();
-                curs_set(0);
-                search_tasks(task_list, *total_tasks, query, selected_task_index);
-                break;
+                    break;
+            }
+        }
+        if (!key_pending()) {
+            render_frame(task_list, *total_tasks, *selected_task_index, *selected_subtask_index, *is_in_subtask_mode, show_next_up);
         }
-        display_tasks(task_list, *total_tasks, *selected_task_index, *is_in_subtask_mode);
-        display_subtasks(task_list, *selected_task_index);
-        display_metadata(task_list, *selected_task_index);
     }
 }